@@ -0,0 +1,98 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Steady-state cost of an expensive, never-failing precondition with the
+// adaptive policy against checking it on every call.
+
+#include <contract/contract.hpp>
+#include <contract/adaptive.hpp>
+
+#include "bench.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+std::vector<int> const & whitelist() {
+    static std::vector<int> const keys = [] {
+        std::vector<int> v;
+        for (int i = 0; i != 256; ++i)
+            v.push_back(i * 7);
+        return v;
+    }();
+    return keys;
+}
+
+bool whitelisted(int key) {
+    return std::find(whitelist().begin(), whitelist().end(), key) != whitelist().end();
+}
+
+#if defined(__GNUC__)
+__attribute__((__noinline__))
+#endif
+int lookup_checked(int key) {
+    CONTRACT(fun) { PRECONDITION(whitelisted(key)); };
+    return key + 1;
+}
+
+namespace adaptive {
+
+CONTRACT_POLICY(contract::adaptive_policy<100000>);
+
+#if defined(__GNUC__)
+__attribute__((__noinline__))
+#endif
+int lookup(int key) {
+    CONTRACT(fun) { PRECONDITION(whitelisted(key)); };
+    return key + 1;
+}
+
+#if defined(__GNUC__)
+__attribute__((__noinline__))
+#endif
+int increment(int key) {
+    CONTRACT(fun) { PRECONDITION(key >= 0); };
+    return key + 1;
+}
+
+} // namespace adaptive
+
+#if defined(__GNUC__)
+__attribute__((__noinline__))
+#endif
+int increment_checked(int key) {
+    CONTRACT(fun) { PRECONDITION(key >= 0); };
+    return key + 1;
+}
+
+} // anon namespace
+
+BENCHMARK(adaptive_demotion) {
+    int const keys[] = {7, 700, 1764, 14};
+    std::size_t i = 0;
+
+    bench::run("PRECONDITION(whitelisted(key))", 2000000, [&] {
+        bench::do_not_optimize(lookup_checked(keys[i++ & 3]));
+    });
+
+    // let the check reach its steady-state sampling stride
+    for (int n = 0; n != 20000000; ++n)
+        bench::do_not_optimize(adaptive::lookup(keys[n & 3]));
+
+    bench::run("PRECONDITION(whitelisted(key)), adaptive", 2000000, [&] {
+        bench::do_not_optimize(adaptive::lookup(keys[i++ & 3]));
+    });
+
+    bench::run("PRECONDITION(key >= 0)", 20000000, [&] {
+        bench::do_not_optimize(increment_checked(keys[i++ & 3]));
+    });
+
+    bench::run("PRECONDITION(key >= 0), adaptive", 20000000, [&] {
+        bench::do_not_optimize(adaptive::increment(keys[i++ & 3]));
+    });
+}
@@ -0,0 +1,10 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Reference: preconditions checked.
+#define ASSUME_BENCH_NAME assume_checked
+#include "assume_kernels.hpp"
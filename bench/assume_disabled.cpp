@@ -0,0 +1,11 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Baseline: preconditions compiled out.
+#define CONTRACT_DISABLE_PRECONDITIONS
+#define ASSUME_BENCH_NAME assume_disabled
+#include "assume_kernels.hpp"
@@ -0,0 +1,13 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Preconditions turned into optimizer hints.  The kernel conditions are free
+// of side effects, so the evaluating fallback is fine for older GCC.
+#define CONTRACT_ASSUME_PRECONDITIONS
+#define CONTRACT_ASSUME_UNREACHABLE
+#define ASSUME_BENCH_NAME assume_enabled
+#include "assume_kernels.hpp"
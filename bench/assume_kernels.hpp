@@ -0,0 +1,77 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Kernels shared by the assume-mode benchmarks.  Included once per contract
+// mode; `ASSUME_BENCH_NAME` names the mode and the enclosing namespace.
+
+#include <contract/contract.hpp>
+
+#include "bench.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace {
+
+#if defined(__GNUC__)
+__attribute__((__noinline__))
+#endif
+int sum(int const * p, std::size_t n) {
+    CONTRACT(fun)
+    {
+        PRECONDITION(p != nullptr);
+        PRECONDITION(n % 16 == 0);
+    };
+
+    // defensive check that an assumed precondition makes dead
+    if (!p)
+        return 0;
+
+    int s = 0;
+    for (std::size_t i = 0; i != n; ++i)
+        s += p[i];
+
+    return s;
+}
+
+#if defined(__GNUC__)
+__attribute__((__noinline__))
+#endif
+void scale(int * dst, int const * src, int k, std::size_t n) {
+    CONTRACT(fun)
+    {
+        PRECONDITION(n % 16 == 0);
+    };
+
+    for (std::size_t i = 0; i != n; ++i)
+        dst[i] = src[i] * k;
+}
+
+} // anon namespace
+
+
+BENCHMARK(ASSUME_BENCH_NAME) {
+    std::vector<int> src(4096, 3);
+    std::vector<int> dst(4096);
+    std::size_t volatile size = 0;
+
+    for (std::size_t n: {16u, 48u, 4096u}) {
+        size = n;
+        char label[64];
+
+        std::snprintf(label, sizeof label, "sum,   n = %zu", n);
+        bench::run(label, 20000000 / n, [&] {
+            bench::do_not_optimize(sum(src.data(), size));
+        });
+
+        std::snprintf(label, sizeof label, "scale, n = %zu", n);
+        bench::run(label, 20000000 / n, [&] {
+            scale(dst.data(), src.data(), 7, size);
+            bench::do_not_optimize(dst[0]);
+        });
+    }
+}
@@ -0,0 +1,10 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+// Preconditions checked with the `quick_enforce` semantic: a failure traps.
+#define CONTRACT_SEMANTIC quick_enforce
+#define ASSUME_BENCH_NAME assume_quick_enforce
+#include "assume_kernels.hpp"
@@ -0,0 +1,147 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef __contract_bench_hpp__included
+#define __contract_bench_hpp__included
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Define a benchmark.
+//
+// The benchmark body is a function registered under `name` and run by the
+// `bench` executable.  It usually consists of one or more <bench::run> calls.
+#define BENCHMARK(name) __bench_benchmark__(name)
+#define __bench_benchmark__(name) \
+    static void name(); \
+    static ::bench::registrar name ## _registrar__{#name, name}; \
+    static void name()
+
+namespace bench {
+
+using benchmark_fn = void (*)();
+
+struct benchmark {
+    char const * name;
+    benchmark_fn fn;
+};
+
+// Holder for the registered benchmarks.
+// Templated with a dummy type to be able to keep it in the header file.
+template <typename = void>
+struct registry {
+    static
+    std::vector<benchmark> & benchmarks() {
+        static std::vector<benchmark> list;
+        return list;
+    }
+};
+
+struct registrar {
+    registrar(char const * name, benchmark_fn fn) {
+        registry<>::benchmarks().push_back(benchmark{name, fn});
+    }
+};
+
+// Prevent the optimizer from discarding a computed value.
+template <typename T>
+inline
+void do_not_optimize(T const & value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static T const volatile * sink;
+    sink = &value;
+#endif
+}
+
+// Run `f` for `iterations` iterations and report the mean time per iteration.
+template <typename Func>
+double run(char const * label, std::size_t iterations, Func f) {
+    // warm up caches and branch predictors
+    for (std::size_t i = 0; i != iterations / 10 + 1; ++i)
+        f();
+
+    auto const start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i != iterations; ++i)
+        f();
+    auto const stop = std::chrono::steady_clock::now();
+
+    double const ns =
+        std::chrono::duration<double, std::nano>(stop - start).count() / iterations;
+    std::printf("  %-52s %12.2f ns/op\n", label, ns);
+    return ns;
+}
+
+// Run `f(i)` for `iterations` iterations on each of `threads` threads at once
+// and report the total throughput.
+template <typename Func>
+double run_threads(char const * label, unsigned threads, std::size_t iterations, Func f) {
+    std::vector<std::thread> workers;
+    std::atomic<unsigned> ready{0};
+    std::atomic<bool> go{false};
+
+    for (unsigned t = 0; t != threads; ++t)
+        workers.emplace_back([&] {
+            ++ready;
+            while (!go.load())
+                std::this_thread::yield();
+            for (std::size_t i = 0; i != iterations; ++i)
+                f(i);
+        });
+
+    while (ready.load() != threads)
+        std::this_thread::yield();
+
+    auto const start = std::chrono::steady_clock::now();
+    go.store(true);
+    for (std::thread & worker: workers)
+        worker.join();
+    auto const stop = std::chrono::steady_clock::now();
+
+    double const mops = threads * iterations
+        / std::chrono::duration<double, std::micro>(stop - start).count();
+    char name[96];
+    std::snprintf(name, sizeof(name), "%s, %u threads", label, threads);
+    std::printf("  %-52s %12.2f Mops/s\n", name, mops);
+    return mops;
+}
+
+// Thread counts to measure scaling with: 1, 2, 4, ... up to the number of
+// hardware threads.
+inline
+std::vector<unsigned> thread_counts() {
+    unsigned const cores = std::thread::hardware_concurrency();
+    std::vector<unsigned> counts;
+    for (unsigned threads = 1; threads < cores; threads *= 2)
+        counts.push_back(threads);
+    counts.push_back(cores ? cores : 1);
+    return counts;
+}
+
+// Run all benchmarks whose name contains `filter` (all if `filter` is null).
+inline
+int run_all(char const * filter) {
+    for (benchmark const & b: registry<>::benchmarks()) {
+        if (filter && !std::strstr(b.name, filter))
+            continue;
+
+        std::printf("%s\n", b.name);
+        b.fn();
+    }
+
+    return 0;
+}
+
+} // namespace bench
+
+#endif // __contract_bench_hpp__included
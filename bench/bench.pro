@@ -0,0 +1,36 @@
+TEMPLATE = app
+CONFIG += console c++11 release
+CONFIG -= app_bundle
+CONFIG -= qt
+
+QMAKE_CXXFLAGS += \
+	-std=c++11 \
+	-pthread
+
+QMAKE_CXXFLAGS_RELEASE += \
+	-O3
+
+SOURCES += \
+	main.cpp \
+	adaptive.cpp \
+	assume_checked.cpp \
+	assume_disabled.cpp \
+	assume_enabled.cpp \
+	assume_quick_enforce.cpp \
+	fault_injection.cpp \
+	format_message.cpp \
+	loop_invariant.cpp \
+	nothrow.cpp \
+	pure.cpp \
+	threads.cpp
+
+HEADERS += \
+	bench.hpp \
+	assume_kernels.hpp
+
+INCLUDEPATH += \
+	../include
+
+LIBS += \
+	-lrt \
+	-pthread
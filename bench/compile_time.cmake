@@ -0,0 +1,91 @@
+# Copyright Alexei Zakharov, 2013.
+# Copyright niXman (i dot nixman dog gmail dot com) 2016.
+#
+# Distributed under the Boost Software License, Version 1.0.
+# (See accompanying file LICENSE_1_0.txt or copy at
+# http://www.boost.org/LICENSE_1_0.txt)
+
+# Measure the time to compile compile_time.cpp in each contract mode.
+#
+# usage: cmake -DCXX=<compiler> -DINCLUDE=<include dir> -DSOURCE=<source>
+#              -DOUTPUT=<object file> [-DRUNS=<n>] [-DMODULE=<interface>]
+#              -P compile_time.cmake
+#
+# The best of RUNS (default 3) compilations is reported for each mode.  With
+# MODULE, the interface of the `contract` module (GCC 11 or later), the C++20
+# modes including the header are compared with the ones importing the module;
+# the module itself is compiled once up front.
+
+cmake_minimum_required(VERSION 3.23)  # TIMESTAMP %f
+
+if(NOT RUNS)
+    set(RUNS 3)
+endif()
+
+# "label|option|option...", the options added to the C++11 defaults
+set(modes
+    "baseline, no contracts|-DCOMPILE_TIME_BASELINE"
+    "checked|"
+    "disabled|-DCONTRACT_DISABLE_PRECONDITIONS|-DCONTRACT_DISABLE_POSTCONDITIONS|-DCONTRACT_DISABLE_INVARIANTS"
+    "instrumented|-DCONTRACT_INSTRUMENTED"
+    "quick_enforce|-DCONTRACT_SEMANTIC=quick_enforce"
+    "separate compilation|-DCONTRACT_SEPARATE_COMPILATION")
+
+if(MODULE)
+    get_filename_component(dir ${OUTPUT} DIRECTORY)
+    set(mapper ${dir}/compile_time.modmap)
+    file(WRITE ${mapper} "contract ${dir}/compile_time.gcm\n")
+
+    execute_process(
+        COMMAND ${CXX} -std=c++20 -fmodules-ts -fmodule-mapper=${mapper} -O2 -I${INCLUDE}
+                -x c++ -c ${MODULE} -o ${dir}/compile_time_module.o
+        RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "compile_time: module interface: compilation failed")
+    endif()
+
+    set(import -std=c++20 -fmodules-ts -fmodule-mapper=${mapper} -DCOMPILE_TIME_MODULE)
+    string(REPLACE ";" "|" import "${import}")
+    list(APPEND modes
+        "checked, C++20|-std=c++20"
+        "checked, C++20, imported|${import}"
+        "library only, C++20|-std=c++20|-DCOMPILE_TIME_NO_CLASSES"
+        "library only, C++20, imported|${import}|-DCOMPILE_TIME_NO_CLASSES")
+endif()
+
+function(now_us out)
+    string(TIMESTAMP seconds "%s" UTC)
+    string(TIMESTAMP micros "%f" UTC)
+    math(EXPR value "${seconds} * 1000000 + ${micros}")
+    set(${out} ${value} PARENT_SCOPE)
+endfunction()
+
+foreach(mode IN LISTS modes)
+    string(REPLACE "|" ";" fields "${mode}")
+    list(GET fields 0 label)
+    list(SUBLIST fields 1 -1 options)
+
+    set(best "")
+    foreach(run RANGE 1 ${RUNS})
+        now_us(start)
+        execute_process(
+            COMMAND ${CXX} -std=c++11 -O2 -I${INCLUDE} ${options} -c ${SOURCE} -o ${OUTPUT}
+            RESULT_VARIABLE result)
+        now_us(stop)
+
+        if(NOT result EQUAL 0)
+            message(FATAL_ERROR "compile_time: ${label}: compilation failed")
+        endif()
+
+        math(EXPR elapsed "${stop} - ${start}")
+        if(best STREQUAL "" OR elapsed LESS best)
+            set(best ${elapsed})
+        endif()
+    endforeach()
+
+    math(EXPR ms "${best} / 1000")
+    string(LENGTH "${label}" size)
+    math(EXPR pad "52 - ${size}")
+    string(REPEAT " " ${pad} spaces)
+    message("  ${label}${spaces} ${ms} ms")
+endforeach()
@@ -0,0 +1,85 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Translation unit for compile time measurements, see compile_time.cmake.  It
+// defines 100 classes with constructor, member function and class contracts
+// and 100 free functions with function contracts.  With
+// `COMPILE_TIME_BASELINE` defined the contracts are left out altogether, with
+// `COMPILE_TIME_MODULE` the library is imported from the `contract` module,
+// and with `COMPILE_TIME_NO_CLASSES` only the library is compiled.
+
+#if defined(COMPILE_TIME_BASELINE)
+#	define COMPILE_TIME_CONTRACT(...)
+#elif defined(COMPILE_TIME_MODULE)
+import contract;
+#	include <contract/macros.hpp>
+#	define COMPILE_TIME_CONTRACT(...) __VA_ARGS__
+#else
+#	include <contract/contract.hpp>
+#	define COMPILE_TIME_CONTRACT(...) __VA_ARGS__
+#endif
+
+#define COMPILE_TIME_CLASS(n) \
+    class account ## n { \
+    public: \
+        explicit account ## n(int balance) \
+            : balance_{balance} \
+        { \
+            COMPILE_TIME_CONTRACT(CONTRACT(ctor) { \
+                PRECONDITION(balance >= 0); \
+                POSTCONDITION(balance_ == balance); \
+            };) \
+        } \
+        \
+        void deposit(int amount) { \
+            COMPILE_TIME_CONTRACT(CONTRACT(mfun) { \
+                PRECONDITION_GT(amount, 0); \
+                POSTCONDITION(balance_ >= amount, "balance overflow"); \
+            };) \
+            balance_ += amount; \
+        } \
+        \
+        int balance() const { \
+            COMPILE_TIME_CONTRACT(CONTRACT(mfun) {};) \
+            return balance_; \
+        } \
+        \
+    private: \
+        COMPILE_TIME_CONTRACT(CONTRACT(class) { INVARIANT(balance_ >= 0); };) \
+        \
+    private: \
+        int balance_; \
+    }; \
+    \
+    int transfer ## n(int amount) { \
+        COMPILE_TIME_CONTRACT(CONTRACT(fun) { \
+            PRECONDITION(amount > 0, "nothing to transfer"); \
+            POSTCONDITION_LE(amount, 1000000); \
+        };) \
+        account ## n a{amount}; \
+        a.deposit(amount); \
+        return a.balance(); \
+    }
+
+#define COMPILE_TIME_10(m, n) \
+    m(n ## 0) m(n ## 1) m(n ## 2) m(n ## 3) m(n ## 4) \
+    m(n ## 5) m(n ## 6) m(n ## 7) m(n ## 8) m(n ## 9)
+
+#define COMPILE_TIME_100 \
+    COMPILE_TIME_10(COMPILE_TIME_CLASS, 0) COMPILE_TIME_10(COMPILE_TIME_CLASS, 1) \
+    COMPILE_TIME_10(COMPILE_TIME_CLASS, 2) COMPILE_TIME_10(COMPILE_TIME_CLASS, 3) \
+    COMPILE_TIME_10(COMPILE_TIME_CLASS, 4) COMPILE_TIME_10(COMPILE_TIME_CLASS, 5) \
+    COMPILE_TIME_10(COMPILE_TIME_CLASS, 6) COMPILE_TIME_10(COMPILE_TIME_CLASS, 7) \
+    COMPILE_TIME_10(COMPILE_TIME_CLASS, 8) COMPILE_TIME_10(COMPILE_TIME_CLASS, 9)
+
+namespace compile_time {
+
+#if !defined(COMPILE_TIME_NO_CLASSES)
+COMPILE_TIME_100
+#endif
+
+} // namespace compile_time
@@ -0,0 +1,102 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Injected violations through observe-mode handlers, on one and many threads.
+
+#define CONTRACT_FAULT_INJECTION
+#include <contract/contract.hpp>
+#include <contract/binary_log.hpp>
+#include <contract/metrics.hpp>
+
+#include "bench.hpp"
+
+#include <atomic>
+#include <string>
+
+#include <unistd.h>
+
+namespace {
+
+// Observe-mode handler that only counts the violations.
+struct counting_policy: contract::default_policy {
+    static void handle(contract::violation_context const &) noexcept {
+        violations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static std::atomic<std::uint64_t> violations;
+};
+
+std::atomic<std::uint64_t> counting_policy::violations{0};
+
+// Observe-mode handler that counts the violations in the metrics segment.
+struct metrics_observe_policy: contract::default_policy {
+    static void count(contract::check_site const & site) noexcept {
+        contract::count_evaluation(site);
+    }
+
+    static void handle(contract::violation_context const & context) noexcept {
+        contract::count_violation(context);
+    }
+};
+
+namespace counted { CONTRACT_POLICY(counting_policy); }
+namespace logged { CONTRACT_POLICY(::contract::log_policy); }
+namespace metered { CONTRACT_POLICY(metrics_observe_policy); }
+
+#define FAULT_BENCH_TARGET \
+    __attribute__((__noinline__)) \
+    int target(int value, int limit) { \
+        CONTRACT(fun) { PRECONDITION_LE(value, limit, "value over limit"); }; \
+        return value; \
+    }
+
+namespace counted { FAULT_BENCH_TARGET }
+namespace logged { FAULT_BENCH_TARGET }
+namespace metered { FAULT_BENCH_TARGET }
+
+} // anon namespace
+
+BENCHMARK(fault_injection) {
+    std::size_t const n = 2000000;
+    int i = 0;
+
+    bench::run("no rules", n, [&] {
+        bench::do_not_optimize(counted::target(i++ & 7, 8));
+    });
+
+    contract::inject_faults(contract::fault_rule::everywhere().probability(0.01));
+    bench::run("1% injected, counting handler", n, [&] {
+        bench::do_not_optimize(counted::target(i++ & 7, 8));
+    });
+    contract::clear_faults();
+
+    contract::inject_faults(contract::fault_rule::at("fault_injection.cpp"));
+    bench::run("all injected, counting handler", n, [&] {
+        bench::do_not_optimize(counted::target(i++ & 7, 8));
+    });
+
+    std::string const log = "/tmp/contract-bench-" + std::to_string(::getpid()) + ".log";
+    contract::open_violation_log(log.c_str(), 512u << 20);
+    bench::run("all injected, binary log", n, [&] {
+        bench::do_not_optimize(logged::target(i++ & 7, 8));
+    });
+    contract::close_violation_log();
+    ::unlink(log.c_str());
+
+    contract::open_metrics();
+    bench::run("all injected, shared-memory metrics", n, [&] {
+        bench::do_not_optimize(metered::target(i++ & 7, 8));
+    });
+    contract::close_metrics();
+
+    for (unsigned threads: bench::thread_counts())
+        bench::run_threads("all injected, counting handler", threads, n, [](std::size_t v) {
+            bench::do_not_optimize(counted::target(static_cast<int>(v & 7), 8));
+        });
+
+    contract::clear_faults();
+}
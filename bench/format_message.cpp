@@ -0,0 +1,64 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Passing checks with a message built eagerly before the check against a
+// message formatted only on violation.
+
+#include <contract/contract.hpp>
+
+#include "bench.hpp"
+
+#include <string>
+
+namespace {
+
+#if defined(__GNUC__)
+__attribute__((__noinline__))
+#endif
+int at_plain(int const * values, int i, int n) {
+    CONTRACT(fun) { PRECONDITION(i >= 0 && i < n, "index out of range"); };
+    return values[i];
+}
+
+#if defined(__GNUC__)
+__attribute__((__noinline__))
+#endif
+int at_eager(int const * values, int i, int n) {
+    std::string const message = "index " + std::to_string(i)
+                              + " out of range [0," + std::to_string(n) + ")";
+    CONTRACT(fun) { PRECONDITION(i >= 0 && i < n, message.c_str()); };
+    return values[i];
+}
+
+#if defined(__GNUC__)
+__attribute__((__noinline__))
+#endif
+int at_formatted(int const * values, int i, int n) {
+    CONTRACT(fun) {
+        PRECONDITION(i >= 0 && i < n, "index {} out of range [0,{})", i, n);
+    };
+    return values[i];
+}
+
+} // anon namespace
+
+BENCHMARK(format_message) {
+    int const values[] = {1, 2, 3, 4};
+    std::size_t i = 0;
+
+    bench::run("literal message", 5000000, [&] {
+        bench::do_not_optimize(at_plain(values, static_cast<int>(i++ & 3), 4));
+    });
+
+    bench::run("message built before the check", 5000000, [&] {
+        bench::do_not_optimize(at_eager(values, static_cast<int>(i++ & 3), 4));
+    });
+
+    bench::run("formatted message", 5000000, [&] {
+        bench::do_not_optimize(at_formatted(values, static_cast<int>(i++ & 3), 4));
+    });
+}
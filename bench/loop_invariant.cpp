@@ -0,0 +1,148 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Numeric loops with loop invariants checked on every iteration
+// (`CONTRACT(loop)`), folded and reported after the loop
+// (`CONTRACT(loop, deferred)`) with and without the failed iteration, and
+// without checks.
+
+#include <contract/contract.hpp>
+
+#include "bench.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace {
+
+__attribute__((__noinline__))
+float sum_unchecked(float const * values, std::size_t size) {
+    float sum = 0;
+    for (std::size_t i = 0; i != size; ++i)
+        sum += values[i] * values[i];
+    return sum;
+}
+
+__attribute__((__noinline__))
+float sum_checked(float const * values, std::size_t size) {
+    float sum = 0;
+    for (std::size_t i = 0; i != size; ++i) {
+        CONTRACT(loop) {
+            INVARIANT(values[i] >= 0.0f);
+        };
+        sum += values[i] * values[i];
+    }
+    return sum;
+}
+
+__attribute__((__noinline__))
+float sum_deferred(float const * values, std::size_t size) {
+    float sum = 0;
+    CONTRACT(loop, deferred) {
+        for (std::size_t i = 0; i != size; ++i) {
+            LOOP_INVARIANT(i, values[i] >= 0.0f);
+            sum += values[i] * values[i];
+        }
+    };
+    return sum;
+}
+
+__attribute__((__noinline__))
+void scale_unchecked(int * values, std::size_t size, int factor) {
+    for (std::size_t i = 0; i != size; ++i)
+        values[i] = values[i] * factor + 1;
+}
+
+__attribute__((__noinline__))
+void scale_checked(int * values, std::size_t size, int factor) {
+    for (std::size_t i = 0; i != size; ++i) {
+        CONTRACT(loop) {
+            INVARIANT(values[i] < (1 << 20));
+        };
+        values[i] = values[i] * factor + 1;
+    }
+}
+
+__attribute__((__noinline__))
+void scale_deferred(int * values, std::size_t size, int factor) {
+    CONTRACT(loop, deferred) {
+        for (std::size_t i = 0; i != size; ++i) {
+            LOOP_INVARIANT(i, values[i] < (1 << 20));
+            values[i] = values[i] * factor + 1;
+        }
+    };
+}
+
+namespace flagged {
+
+struct flag_policy: contract::default_policy {
+    static constexpr bool loop_iterations = false;
+};
+
+CONTRACT_POLICY(flag_policy);
+
+__attribute__((__noinline__))
+float sum_deferred(float const * values, std::size_t size) {
+    float sum = 0;
+    CONTRACT(loop, deferred) {
+        for (std::size_t i = 0; i != size; ++i) {
+            LOOP_INVARIANT(i, values[i] >= 0.0f);
+            sum += values[i] * values[i];
+        }
+    };
+    return sum;
+}
+
+__attribute__((__noinline__))
+void scale_deferred(int * values, std::size_t size, int factor) {
+    CONTRACT(loop, deferred) {
+        for (std::size_t i = 0; i != size; ++i) {
+            LOOP_INVARIANT(i, values[i] < (1 << 20));
+            values[i] = values[i] * factor + 1;
+        }
+    };
+}
+
+} // namespace flagged
+
+} // anon namespace
+
+BENCHMARK(loop_invariant) {
+    std::size_t const n = 20000;
+    std::vector<float> floats(4096, 0.5f);
+    std::vector<int> ints(4096, 1);
+
+    bench::run("sum of squares, no checks", n, [&] {
+        bench::do_not_optimize(sum_unchecked(floats.data(), floats.size()));
+    });
+    bench::run("sum of squares, CONTRACT(loop)", n, [&] {
+        bench::do_not_optimize(sum_checked(floats.data(), floats.size()));
+    });
+    bench::run("sum of squares, CONTRACT(loop, deferred)", n, [&] {
+        bench::do_not_optimize(sum_deferred(floats.data(), floats.size()));
+    });
+    bench::run("sum of squares, deferred without iterations", n, [&] {
+        bench::do_not_optimize(flagged::sum_deferred(floats.data(), floats.size()));
+    });
+
+    bench::run("scale, no checks", n, [&] {
+        scale_unchecked(ints.data(), ints.size(), 1);
+        bench::do_not_optimize(ints[0]);
+    });
+    bench::run("scale, CONTRACT(loop)", n, [&] {
+        scale_checked(ints.data(), ints.size(), 1);
+        bench::do_not_optimize(ints[0]);
+    });
+    bench::run("scale, CONTRACT(loop, deferred)", n, [&] {
+        scale_deferred(ints.data(), ints.size(), 1);
+        bench::do_not_optimize(ints[0]);
+    });
+    bench::run("scale, deferred without iterations", n, [&] {
+        flagged::scale_deferred(ints.data(), ints.size(), 1);
+        bench::do_not_optimize(ints[0]);
+    });
+}
@@ -0,0 +1,13 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "bench.hpp"
+
+// usage: bench [name-filter]
+int main(int argc, char ** argv) {
+    return bench::run_all(argc > 1 ? argv[1] : nullptr);
+}
@@ -0,0 +1,77 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Vector growth of a type whose move constructor has a contract: copied on
+// reallocation unless the contract policy is `nothrow`.
+
+#include <contract/contract.hpp>
+
+#include "bench.hpp"
+
+#include <vector>
+
+namespace {
+
+#define NOTHROW_BENCH_BUFFER \
+    class buffer { \
+    public: \
+        explicit buffer(std::size_t size) \
+            : data_(size) \
+        {} \
+        \
+        buffer(buffer const &) = default; \
+        \
+        buffer(buffer && other) CONTRACT_NOEXCEPT \
+            : data_(std::move(other.data_)) \
+        { \
+            CONTRACT(ctor) {}; \
+        } \
+        \
+        std::size_t size() const { return data_.size(); } \
+        \
+    private: \
+        CONTRACT(class) { INVARIANT(data_.size() <= data_.capacity()); }; \
+        \
+    private: \
+        std::vector<int> data_; \
+    };
+
+namespace checked {
+
+NOTHROW_BENCH_BUFFER
+
+} // namespace checked
+
+namespace nothrow {
+
+CONTRACT_POLICY(::contract::nothrow_policy<>);
+
+NOTHROW_BENCH_BUFFER
+
+} // namespace nothrow
+
+template <typename Buffer>
+__attribute__((__noinline__))
+std::size_t grow(std::size_t count) {
+    std::vector<Buffer> buffers;
+    for (std::size_t i = 0; i != count; ++i)
+        buffers.emplace_back(64);
+    return buffers.size();
+}
+
+} // anon namespace
+
+BENCHMARK(nothrow_move) {
+    std::size_t const n = 2000;
+
+    bench::run("grow to 1000 buffers, default policy (copies)", n, [] {
+        bench::do_not_optimize(grow<checked::buffer>(1000));
+    });
+    bench::run("grow to 1000 buffers, nothrow policy (moves)", n, [] {
+        bench::do_not_optimize(grow<nothrow::buffer>(1000));
+    });
+}
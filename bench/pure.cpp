@@ -0,0 +1,64 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Memoized pure predicates against re-validating the same configuration.
+
+#include <contract/contract.hpp>
+#include <contract/pure.hpp>
+
+#include "bench.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<int> const & whitelist() {
+    static std::vector<int> const keys = [] {
+        std::vector<int> v;
+        for (int i = 0; i != 256; ++i)
+            v.push_back(i * 7);
+        return v;
+    }();
+    return keys;
+}
+
+bool whitelisted(int key) {
+    return std::find(whitelist().begin(), whitelist().end(), key) != whitelist().end();
+}
+
+#if defined(__GNUC__)
+__attribute__((__noinline__))
+#endif
+int lookup_checked(int key) {
+    CONTRACT(fun) { PRECONDITION(whitelisted(key)); };
+    return key + 1;
+}
+
+#if defined(__GNUC__)
+__attribute__((__noinline__))
+#endif
+int lookup_pure(int key) {
+    CONTRACT(fun) { PRECONDITION_PURE(whitelisted, key); };
+    return key + 1;
+}
+
+} // anon namespace
+
+BENCHMARK(pure_predicate) {
+    int const keys[] = {7, 700, 1764, 14};
+    std::size_t i = 0;
+
+    bench::run("PRECONDITION(whitelisted(key))", 2000000, [&] {
+        bench::do_not_optimize(lookup_checked(keys[i++ & 3]));
+    });
+
+    bench::run("PRECONDITION_PURE(whitelisted, key)", 2000000, [&] {
+        bench::do_not_optimize(lookup_pure(keys[i++ & 3]));
+    });
+}
@@ -0,0 +1,103 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Scaling of contract checks with the number of threads.  Checks on shared
+// objects and violations reported from many threads should not serialize.
+
+#include <contract/contract.hpp>
+
+#include "bench.hpp"
+
+#include <atomic>
+
+namespace {
+
+class ledger {
+public:
+    explicit ledger(int entries)
+        : entries_{entries}
+    {}
+
+    __attribute__((__noinline__))
+    int entries(int at) const {
+        CONTRACT(mfun) {
+            PRECONDITION(at >= 0);
+            POSTCONDITION(entries_ > 0);
+        };
+
+        return entries_ + at;
+    }
+
+private:
+    CONTRACT(class) { INVARIANT(entries_ >= 0); };
+
+private:
+    int entries_;
+};
+
+namespace observed {
+
+// Observe-mode handler that counts the violations.
+struct observe_policy: contract::default_policy {
+    static void handle(contract::violation_context const &) noexcept {
+        violations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static std::atomic<std::uint64_t> violations;
+};
+
+std::atomic<std::uint64_t> observe_policy::violations{0};
+
+CONTRACT_POLICY(observe_policy);
+
+__attribute__((__noinline__))
+int transfer(int amount) {
+    CONTRACT(fun) { PRECONDITION_GT(amount, 0); };
+    return amount;
+}
+
+} // namespace observed
+
+struct handler_error {};
+
+void throwing_handler(contract::violation_context const &) {
+    throw handler_error{};
+}
+
+__attribute__((__noinline__))
+int checked_transfer(int amount) {
+    CONTRACT(fun) { PRECONDITION(amount > 0); };
+    return amount;
+}
+
+} // anon namespace
+
+BENCHMARK(threads) {
+    std::size_t const n = 2000000;
+    ledger const shared{3};
+
+    for (unsigned threads: bench::thread_counts())
+        bench::run_threads("mfun on a shared const object", threads, n, [&](std::size_t i) {
+            bench::do_not_optimize(shared.entries(static_cast<int>(i & 7)));
+        });
+
+    for (unsigned threads: bench::thread_counts())
+        bench::run_threads("violations, observe policy", threads, n, [](std::size_t i) {
+            bench::do_not_optimize(observed::transfer(-static_cast<int>(i & 7)));
+        });
+
+    // every violation goes through the installed handler
+    contract::violation_handler old_handler = contract::set_handler(throwing_handler);
+    for (unsigned threads: bench::thread_counts())
+        bench::run_threads("violations, set_handler handler", threads, n / 10, [](std::size_t i) {
+            try {
+                bench::do_not_optimize(checked_transfer(-static_cast<int>(i & 7)));
+            } catch (handler_error &) {
+            }
+        });
+    contract::set_handler(old_handler);
+}
@@ -0,0 +1,329 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef __contract_adaptive_hpp__included
+#define __contract_adaptive_hpp__included
+
+/***************************************************************************/
+
+#include <contract/contract.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+/***************************************************************************/
+
+// Number of check sites the adaptive policy keeps statistics for; a power of
+// two.  Further sites are always checked.
+#if !defined(CONTRACT_ADAPTIVE_SITES)
+#	define CONTRACT_ADAPTIVE_SITES 1024
+#endif
+
+/***************************************************************************/
+
+namespace contract {
+
+// interface: adaptive checking
+//
+
+// Contract policy that demotes expensive checks which never fail to sampled
+// checking.
+//
+// Every thread times one in 64 evaluations of each contract check and
+// compares the time of the check with the time between its evaluations on
+// that thread, which for a function called over and over is its share of the
+// enclosing call.  A check that has passed `Passes` times since it was last
+// demoted, and takes more than `Percent` percent of that time, is evaluated
+// half as often as before: first one call in 2, then one in 4 and so on down
+// to one in about a million, each step after `Passes` more passes.  The
+// first demotion of a check is logged to the standard error.  A violation
+// restores full checking of the failed check and starts its count over, and
+// checks seen for the first time are always checked, so new code paths stay
+// fully checked while the steady-state overhead of long-running processes
+// converges to nearly nothing.  Keeping the statistics costs a few
+// nanoseconds per evaluation, which only pays off for checks costing more
+// than that.  Deferred loop invariants are not demoted.
+//
+// Otherwise behaves as `Policy`.
+template <std::uint64_t Passes = 1000000, unsigned Percent = 10,
+          typename Policy = default_policy>
+struct adaptive_policy: Policy {
+    class check_probe;
+
+    static void handle(violation_context const & context)
+        noexcept(noexcept(Policy::handle(context)));
+};
+
+// Get the sampling stride of a contract check of an adaptive policy.
+//
+// @site     site id of the check, see <violation_context>.
+// @returns  `n` if the check is evaluated in one call in `n`; 1 for a check
+//           that is fully checked or unknown.
+std::uint64_t adaptive_stride(std::uint64_t site) noexcept;
+
+/***************************************************************************/
+
+namespace detail {
+
+// implementation: adaptive checking
+//
+
+// Shared statistics of a check site.  Counters are updated with relaxed
+// atomic operations, every 64 evaluations of the site by a thread.
+struct adaptive_site {
+    std::atomic<std::uint64_t> id;          // site id; 0 if not in use yet
+    std::atomic<std::uint64_t> passes;      // evaluations since the last change
+    std::atomic<unsigned> shift;            // log2 of the sampling stride
+    std::atomic<bool> logged;               // whether the demotion was logged
+};
+
+// Statistics of a check site kept by each thread.
+struct adaptive_local {
+    std::uint64_t evaluations;              // evaluations by this thread
+    std::uint64_t cost;                     // time of the check, ns
+    std::int64_t timed;                     // start of the last timed evaluation
+};
+
+// Holder for the statistics of the check sites.
+// Templated with a dummy type to be able to keep it in the header file.
+template <typename = void>
+struct adaptive_holder {
+    static_assert((CONTRACT_ADAPTIVE_SITES & (CONTRACT_ADAPTIVE_SITES - 1)) == 0,
+                  "CONTRACT_ADAPTIVE_SITES must be a power of two");
+
+    // one evaluation in `timing` is timed
+    static constexpr std::uint64_t timing = 64;
+    static constexpr unsigned max_shift = 20;
+
+    static adaptive_site sites[CONTRACT_ADAPTIVE_SITES];
+
+    static
+    adaptive_local * locals() noexcept {
+        static thread_local adaptive_local local[CONTRACT_ADAPTIVE_SITES];
+        return local;
+    }
+
+    // xorshift64* per thread; seeded on first use, so that the state needs no
+    // guard of its initialization
+    static
+    std::uint64_t random() noexcept {
+        static thread_local std::uint64_t state = 0;
+        if (state == 0)
+            state = 0x9e3779b97f4a7c15ull ^ reinterpret_cast<std::uintptr_t>(&state);
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545f4914f6cdd1dull;
+    }
+
+    static
+    std::int64_t now() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // time taken by reading the clock, not counted in the time of a check
+    static
+    std::int64_t overhead() noexcept {
+        static thread_local std::int64_t const least = [] {
+            std::int64_t least = 0;
+            for (int i = 0; i != 16; ++i) {
+                std::int64_t const start = now();
+                std::int64_t const taken = now() - start;
+                if (i == 0 || taken < least)
+                    least = taken;
+            }
+            return least;
+        }();
+        return least;
+    }
+};
+
+template <typename T>
+constexpr std::uint64_t adaptive_holder<T>::timing;
+
+template <typename T>
+constexpr unsigned adaptive_holder<T>::max_shift;
+
+template <typename T>
+adaptive_site adaptive_holder<T>::sites[CONTRACT_ADAPTIVE_SITES];
+
+// Search the statistics of the site `id` past its first slot.
+inline
+std::size_t adaptive_search(std::uint64_t id, bool claim) noexcept {
+    adaptive_site * sites = adaptive_holder<>::sites;
+
+    for (std::size_t i = 0; i != CONTRACT_ADAPTIVE_SITES; ++i) {
+        std::size_t const at = (id + i) & (CONTRACT_ADAPTIVE_SITES - 1);
+        std::uint64_t seen = sites[at].id.load(std::memory_order_relaxed);
+
+        if (seen == id)
+            return at;
+        if (seen == 0) {
+            if (!claim)
+                return CONTRACT_ADAPTIVE_SITES;
+            if (sites[at].id.compare_exchange_strong(seen, id) || seen == id)
+                return at;
+        }
+    }
+
+    return CONTRACT_ADAPTIVE_SITES;
+}
+
+// Find the index of the statistics of the site `id`, claiming them if `claim`
+// is set.  Returns `CONTRACT_ADAPTIVE_SITES` if the site has none.
+inline
+std::size_t adaptive_find(std::uint64_t id, bool claim) noexcept {
+    std::size_t const at = id & (CONTRACT_ADAPTIVE_SITES - 1);
+    if (adaptive_holder<>::sites[at].id.load(std::memory_order_relaxed) == id)
+        return at;
+    return adaptive_search(id, claim);
+}
+
+inline
+void adaptive_log(check_site const & site, std::uint64_t passes) {
+    std::cerr << site.file << ':' << site.line
+              << ": note: contract check of type '" << type_name(site.contract_type)
+              << "' demoted to sampled checking after " << passes << " passes\n"
+              << "condition: " << site.condition << "\n";
+    std::cerr.flush();
+}
+
+// Start a timed evaluation of the site `site` at `index`: demote it if the
+// previous timed evaluation found it expensive enough.  Returns the start
+// time of the evaluation.
+template <std::uint64_t Passes, unsigned Percent>
+std::int64_t adaptive_enter(check_site const & site, std::size_t index) noexcept {
+    using holder = adaptive_holder<>;
+
+    adaptive_site & shared = holder::sites[index];
+    adaptive_local & local = holder::locals()[index];
+    std::int64_t const start = holder::now();
+
+    // the time since the previous timed evaluation covers `timing`
+    // evaluations of `2^shift` calls each
+    std::int64_t const previous = local.timed;
+    local.timed = start;
+
+    unsigned const shift = shared.shift.load(std::memory_order_relaxed);
+    std::uint64_t const passes =
+        shared.passes.fetch_add(holder::timing, std::memory_order_relaxed) + holder::timing;
+    if (previous == 0 || passes < Passes || shift == holder::max_shift)
+        return start;
+
+    std::uint64_t const period = static_cast<std::uint64_t>(start - previous);
+    if (local.cost * (holder::timing << shift) * 100 <= period * Percent)
+        return start;
+
+    unsigned expected = shift;
+    if (!shared.shift.compare_exchange_strong(expected, shift + 1, std::memory_order_relaxed))
+        return start;
+    shared.passes.store(0, std::memory_order_relaxed);
+
+    if (!shared.logged.exchange(true, std::memory_order_relaxed)) {
+        try {
+            adaptive_log(site, passes);
+        } catch (...) {
+        }
+    }
+
+    return holder::now();
+}
+
+// Finish the timed evaluation of the site at `index` started at `start`.
+inline
+void adaptive_leave(std::size_t index, std::int64_t start) noexcept {
+    using holder = adaptive_holder<>;
+
+    adaptive_local & local = holder::locals()[index];
+    std::int64_t const taken = holder::now() - start - holder::overhead();
+
+    // a decaying minimum: it follows faster checks at once and slower ones
+    // by an eighth per timing, so a preempted check doesn't look expensive
+    std::uint64_t const cost = taken > 0 ? static_cast<std::uint64_t>(taken) : 1;
+    std::uint64_t const limit = local.cost + local.cost / 8 + 1;
+    local.cost = local.cost == 0 || cost < limit ? cost : limit;
+}
+
+} // namespace detail
+
+/***************************************************************************/
+
+// Probe of the contract checks of an <adaptive_policy>: lets through the
+// sampled evaluations of a site and times one in 64 of them.
+template <std::uint64_t Passes, unsigned Percent, typename Policy>
+class adaptive_policy<Passes, Percent, Policy>::check_probe {
+public:
+    explicit
+    check_probe(check_site const & site) noexcept(noexcept(Policy::count(site)))
+        :index_{detail::adaptive_find(site.id, true)}
+        ,start_{0}
+        ,evaluate_{true}
+    {
+        using holder = detail::adaptive_holder<>;
+
+        if (index_ != CONTRACT_ADAPTIVE_SITES) {
+            unsigned const shift = holder::sites[index_].shift.load(std::memory_order_relaxed);
+            if (shift != 0 && (holder::random() >> (64 - shift)) != 0) {
+                evaluate_ = false;
+                return;
+            }
+
+            if (++holder::locals()[index_].evaluations % holder::timing == 0)
+                start_ = detail::adaptive_enter<Passes, Percent>(site, index_);
+        }
+
+        Policy::count(site);
+    }
+
+    ~check_probe() {
+        if (start_ != 0)
+            detail::adaptive_leave(index_, start_);
+    }
+
+    check_probe(check_probe const &) = delete;
+    check_probe & operator=(check_probe const &) = delete;
+
+    explicit operator bool() const noexcept { return evaluate_; }
+
+private:
+    std::size_t const index_;
+    std::int64_t start_;
+    bool evaluate_;
+};
+
+template <std::uint64_t Passes, unsigned Percent, typename Policy>
+void adaptive_policy<Passes, Percent, Policy>::handle(violation_context const & context)
+    noexcept(noexcept(Policy::handle(context)))
+{
+    std::size_t const index = detail::adaptive_find(context.site, false);
+    if (index != CONTRACT_ADAPTIVE_SITES) {
+        detail::adaptive_site & shared = detail::adaptive_holder<>::sites[index];
+        shared.shift.store(0, std::memory_order_relaxed);
+        shared.passes.store(0, std::memory_order_relaxed);
+    }
+
+    Policy::handle(context);
+}
+
+inline
+std::uint64_t adaptive_stride(std::uint64_t site) noexcept {
+    std::size_t const index = detail::adaptive_find(site, false);
+    if (index == CONTRACT_ADAPTIVE_SITES)
+        return 1;
+    return std::uint64_t{1}
+        << detail::adaptive_holder<>::sites[index].shift.load(std::memory_order_relaxed);
+}
+
+} // namespace contract
+
+/***************************************************************************/
+
+#endif // __contract_adaptive_hpp__included
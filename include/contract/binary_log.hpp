@@ -0,0 +1,371 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef __contract_binary_log_hpp__included
+#define __contract_binary_log_hpp__included
+
+/***************************************************************************/
+
+#include <contract/contract.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/***************************************************************************/
+
+// Size in bytes of a new binary violation log file.
+#if !defined(CONTRACT_LOG_CAPACITY)
+#	define CONTRACT_LOG_CAPACITY (64u << 20)
+#endif
+
+// Number of check sites remembered as already described in the log; a power
+// of two.  Sites beyond that are described again on every violation.
+#if !defined(CONTRACT_LOG_SITES)
+#	define CONTRACT_LOG_SITES 4096
+#endif
+
+/***************************************************************************/
+
+namespace contract {
+
+// interface: binary violation log format
+//
+
+// The binary violation log is a file of fixed size made of 64-byte slots.  The
+// first slot holds the <log_header>, the others hold records appended in the
+// order their space was reserved.  The first byte of a record is its
+// <log_record_kind>; it is written last, so a slot whose kind is `empty` was
+// reserved but never completed and is skipped.  Every violation is an
+// <log_event> record identified by the site id of the contract check.  The
+// first violation of a site in a log is preceded by a <log_site> record that
+// maps the site id to its file, line, condition and message.  All integers
+// are in the byte order of the writing host.
+
+enum class log_record_kind: std::uint8_t {
+     empty
+    ,site
+    ,event
+};
+
+struct log_header {
+    enum: std::uint32_t {
+         magic_value   = 0x474c5443  // "CTLG"
+        ,version_value = 1
+        ,slot_size     = 64
+    };
+
+    std::uint32_t magic;          // <magic_value>
+    std::uint32_t version;        // <version_value>
+    std::uint64_t capacity;       // size of the log file in bytes
+    std::uint64_t tail;           // end of the reserved slots; may exceed capacity
+    std::uint64_t dropped;        // records that didn't fit
+    unsigned char reserved[32];
+};
+
+struct log_event {
+    std::uint8_t  kind;           // <log_record_kind::event>
+    std::uint8_t  contract_type;  // <contract::type> of the failed check
+    std::uint8_t  lhs_kind;       // <captured_value::kind> of the left operand
+    std::uint8_t  rhs_kind;       // <captured_value::kind> of the right operand
+    std::uint8_t  lhs_size;       // bytes in `lhs`; `truncated_bit` if cut
+    std::uint8_t  rhs_size;       // bytes in `rhs`; `truncated_bit` if cut
+    std::uint16_t reserved;
+    std::uint64_t site;           // site id of the failed check
+    std::uint64_t thread;         // hash of the id of the reporting thread
+    std::uint64_t time;           // steady clock time in nanoseconds
+    unsigned char lhs[16];        // <captured_value::copy_bytes> of the operands
+    unsigned char rhs[16];
+
+    enum: std::uint8_t { truncated_bit = 0x80 };
+};
+
+struct log_site {
+    std::uint8_t  kind;           // <log_record_kind::site>
+    std::uint8_t  contract_type;  // <contract::type> of the check
+    std::uint16_t slots;          // slots following this one with more `text`
+    std::uint32_t line;           // line of the check
+    std::uint64_t site;           // site id of the check
+    char text[48];                // "file\0condition\0message\0", continued in
+                                  // the following slots
+};
+
+static_assert(sizeof(log_header) == log_header::slot_size, "bad log header layout");
+static_assert(sizeof(log_event) == log_header::slot_size, "bad log event layout");
+static_assert(sizeof(log_site) == log_header::slot_size, "bad log site layout");
+
+// interface: binary violation log
+//
+
+// Open the binary violation log.
+//
+// Map the log file into memory; later violations passed to <log_violation>
+// are appended to it.  An existing log is appended to, a new one is created
+// with the size `capacity`.  The log never grows: records that don't fit are
+// only counted in <log_header::dropped>.  A log that is already open is
+// closed first.  Opening and closing must not race with logging.
+//
+// @path      the log file.
+// @capacity  size of a new log file in bytes.
+// @returns   `false` if the file can't be opened or mapped or is not a log.
+__ct_decl__ bool open_violation_log(char const * path,
+                                    std::size_t capacity = CONTRACT_LOG_CAPACITY);
+
+// Close the binary violation log.
+__ct_decl__ void close_violation_log();
+
+// Append a contract violation to the binary violation log.
+//
+// Write a <log_event> record, preceded by a <log_site> record the first time
+// the site is seen.  Space is reserved with an atomic increment in the
+// mapped header, so any number of threads and processes can log at once
+// without locking.  Does nothing if no log is open.
+//
+// @context  the context data for the contract violation.
+__ct_decl__ void log_violation(violation_context const & context) noexcept;
+
+// Contract policy for the observe mode: violations are appended to the binary
+// violation log and the execution continues.
+struct log_policy: default_policy {
+    static void handle(violation_context const & context) noexcept {
+        log_violation(context);
+    }
+};
+
+/***************************************************************************/
+
+#if defined(__ct_compile_library__)
+
+namespace detail {
+
+// implementation: binary violation log
+//
+
+// Holder for the mapped log and the sites already described in it.
+// Templated with a dummy type to be able to keep it in the header file.
+template <typename = void>
+struct log_holder {
+    static_assert((CONTRACT_LOG_SITES & (CONTRACT_LOG_SITES - 1)) == 0,
+                  "CONTRACT_LOG_SITES must be a power of two");
+
+    static std::atomic<char *> base;
+    static std::atomic<std::uint64_t> sites[CONTRACT_LOG_SITES];
+
+    static
+    std::uint64_t thread() noexcept {
+        static thread_local std::uint64_t const id =
+            std::hash<std::thread::id>{}(std::this_thread::get_id());
+        return id;
+    }
+};
+
+template <typename T>
+std::atomic<char *> log_holder<T>::base{nullptr};
+
+template <typename T>
+std::atomic<std::uint64_t> log_holder<T>::sites[CONTRACT_LOG_SITES];
+
+// Whether `site` is logged for the first time; claims it if so.
+inline
+bool log_first_sight(std::uint64_t site) noexcept {
+    std::atomic<std::uint64_t> * sites = log_holder<>::sites;
+
+    for (std::size_t i = 0; i != CONTRACT_LOG_SITES; ++i) {
+        std::atomic<std::uint64_t> & entry =
+            sites[(site + i) & (CONTRACT_LOG_SITES - 1)];
+        std::uint64_t seen = entry.load(std::memory_order_relaxed);
+
+        if (seen == 0 && entry.compare_exchange_strong(seen, site))
+            return true;
+        if (seen == site)
+            return false;
+    }
+
+    return true;
+}
+
+// Reserve `slots` consecutive slots in the log at `base`.
+inline
+char * log_reserve(char * base, std::size_t slots) noexcept {
+    log_header * header = reinterpret_cast<log_header *>(base);
+    std::uint64_t const size = slots * log_header::slot_size;
+    std::uint64_t const offset = __atomic_fetch_add(&header->tail, size, __ATOMIC_RELAXED);
+
+    if (offset + size > header->capacity) {
+        __atomic_fetch_add(&header->dropped, 1, __ATOMIC_RELAXED);
+        return nullptr;
+    }
+
+    return base + offset;
+}
+
+// Publish a record whose body is written by setting its kind.
+inline
+void log_publish(char * record, log_record_kind kind) noexcept {
+    __atomic_store_n(reinterpret_cast<std::uint8_t *>(record),
+                     static_cast<std::uint8_t>(kind),
+                     __ATOMIC_RELEASE);
+}
+
+inline
+void log_site_record(char * base, violation_context const & context) noexcept {
+    // up to 15 continuation slots of "file\0condition\0message\0"
+    char text[sizeof(log_site::text) + 15 * log_header::slot_size];
+    std::size_t size = 0;
+
+    for (char const * s: {context.file, context.condition, context.message}) {
+        for (; s && *s && size + 1 < sizeof(text); ++s)
+            text[size++] = *s;
+        if (size < sizeof(text))
+            text[size++] = '\0';
+    }
+
+    std::size_t const more = size > sizeof(log_site::text)
+        ? (size - sizeof(log_site::text) + log_header::slot_size - 1) / log_header::slot_size
+        : 0;
+
+    char * record = log_reserve(base, 1 + more);
+    if (!record)
+        return;
+
+    log_site site;
+    std::memset(&site, 0, sizeof(site));
+    site.contract_type = static_cast<std::uint8_t>(context.contract_type);
+    site.slots = static_cast<std::uint16_t>(more);
+    site.line = static_cast<std::uint32_t>(context.line);
+    site.site = context.site;
+
+    std::size_t const head = size < sizeof(site.text) ? size : sizeof(site.text);
+    std::memcpy(site.text, text, head);
+    std::memcpy(record, &site, sizeof(site));
+    std::memset(record + sizeof(site), 0, more * log_header::slot_size);
+    std::memcpy(record + sizeof(site), text + head, size - head);
+
+    log_publish(record, log_record_kind::site);
+}
+
+// Copy the bytes of an operand into an event; returns the size field.
+inline
+std::uint8_t log_operand(captured_value const & value, unsigned char (&bytes)[16]) noexcept {
+    unsigned char full[CONTRACT_CAPTURE_TEXT_SIZE + 8];
+    std::size_t size = value.copy_bytes(full, sizeof(full));
+    bool const cut = value.truncated() || size > sizeof(bytes);
+
+    if (size > sizeof(bytes))
+        size = sizeof(bytes);
+    std::memcpy(bytes, full, size);
+    return static_cast<std::uint8_t>(size | (cut ? log_event::truncated_bit : 0));
+}
+
+} // namespace detail
+
+/***************************************************************************/
+
+__ct_inline__
+bool open_violation_log(char const * path, std::size_t capacity) {
+    close_violation_log();
+
+    int const fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+        return false;
+
+    struct ::stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    bool const created = st.st_size == 0;
+    if (created) {
+        if (capacity < 2 * log_header::slot_size
+            || ::ftruncate(fd, static_cast<::off_t>(capacity)) != 0) {
+            ::close(fd);
+            return false;
+        }
+    } else {
+        capacity = static_cast<std::size_t>(st.st_size);
+    }
+
+    void * map = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+        return false;
+
+    log_header * header = static_cast<log_header *>(map);
+    if (created) {
+        header->magic = log_header::magic_value;
+        header->version = log_header::version_value;
+        header->capacity = capacity;
+        header->tail = log_header::slot_size;
+        header->dropped = 0;
+    } else if (header->magic != log_header::magic_value
+               || header->version != log_header::version_value
+               || header->capacity != capacity) {
+        ::munmap(map, capacity);
+        return false;
+    }
+
+    for (std::atomic<std::uint64_t> & site: detail::log_holder<>::sites)
+        site.store(0, std::memory_order_relaxed);
+
+    detail::log_holder<>::base.store(static_cast<char *>(map));
+    return true;
+}
+
+__ct_inline__
+void close_violation_log() {
+    char * base = detail::log_holder<>::base.exchange(nullptr);
+    if (base)
+        ::munmap(base, reinterpret_cast<log_header *>(base)->capacity);
+}
+
+__ct_inline__
+void log_violation(violation_context const & context) noexcept {
+    char * base = detail::log_holder<>::base.load(std::memory_order_acquire);
+    if (!base)
+        return;
+
+    if (detail::log_first_sight(context.site))
+        detail::log_site_record(base, context);
+
+    char * record = detail::log_reserve(base, 1);
+    if (!record)
+        return;
+
+    log_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.contract_type = static_cast<std::uint8_t>(context.contract_type);
+    event.lhs_kind = static_cast<std::uint8_t>(context.lhs.get_kind());
+    event.rhs_kind = static_cast<std::uint8_t>(context.rhs.get_kind());
+    event.lhs_size = detail::log_operand(context.lhs, event.lhs);
+    event.rhs_size = detail::log_operand(context.rhs, event.rhs);
+    event.site = context.site;
+    event.thread = detail::log_holder<>::thread();
+    event.time = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+
+    std::memcpy(record, &event, sizeof(event));
+    detail::log_publish(record, log_record_kind::event);
+}
+
+#endif // __ct_compile_library__
+
+} // namespace contract
+
+/***************************************************************************/
+
+#endif // __contract_binary_log_hpp__included
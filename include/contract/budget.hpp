@@ -0,0 +1,139 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef __contract_budget_hpp__included
+#define __contract_budget_hpp__included
+
+/***************************************************************************/
+
+#include <contract/contract.hpp>
+
+#include <chrono>
+#include <cstdint>
+
+/***************************************************************************/
+
+// implementation: macros
+//
+
+// Evaluation option for `CONTRACT(class, budget(us))`.
+#define __ct_option_budget(us) ::contract::detail::budget_option<us>
+
+/***************************************************************************/
+
+namespace contract {
+
+// interface: invariant budget report
+//
+
+// Invariant checks done and shed by the budgeted class contracts of a thread.
+struct budget_report {
+    std::uint64_t checked;  // number of invariant checks done
+    std::uint64_t shed;     // number of invariant checks skipped
+};
+
+// Get the invariant budget report of the current thread.
+//
+// @returns  the number of invariant checks of class contracts with a
+//           `budget(us)` option that were done and shed on this thread.
+budget_report get_budget_report();
+
+/***************************************************************************/
+
+namespace detail {
+
+// implementation: code behind macros
+//
+
+// Holder for the invariant budget report of the current thread.
+// Templated with a dummy type to be able to keep it in the header file.
+template <typename = void>
+struct budget_report_holder {
+    static
+    budget_report & current() {
+        static thread_local budget_report report{0, 0};
+        return report;
+    }
+};
+
+// Class contract evaluation option that bounds the time spent checking the
+// class invariant.  Every thread has a budget of `Micros` microseconds of
+// invariant checking per class, refilled at `Micros` microseconds per second.
+// Once the budget is exhausted, invariant checks are shed until enough of it
+// is refilled.  The check that exhausts the budget is always completed, so a
+// single check can overdraw it.
+template <std::uint64_t Micros>
+struct budget_option {
+    using clock = std::chrono::steady_clock;
+
+    // Budget state of a thread, in nanoseconds of checking.
+    struct state {
+        std::int64_t available;
+        clock::time_point refilled;
+    };
+
+    static constexpr std::int64_t capacity = Micros * 1000;
+
+    template <typename T>
+    static
+    state & local() {
+        static thread_local state st{capacity, clock::now()};
+        return st;
+    }
+
+    template <typename T>
+    static
+    void evaluate(T const * obj, void (*check)(T const *), bool /*exit*/) {
+        state & st = local<T>();
+        budget_report & report = budget_report_holder<>::current();
+
+        clock::time_point const start = clock::now();
+        std::int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            start - st.refilled).count();
+        if (elapsed > 1000000000)
+            elapsed = 1000000000;
+
+        // the refill time is only moved when the budget actually grows, so
+        // frequent checks don't lose their refill to rounding
+        std::int64_t const refill = elapsed * static_cast<std::int64_t>(Micros) / 1000000;
+        if (refill > 0) {
+            st.available += refill;
+            if (st.available > capacity)
+                st.available = capacity;
+            st.refilled = start;
+        }
+
+        if (st.available <= 0) {
+            ++report.shed;
+            return;
+        }
+
+        ++report.checked;
+        check(obj);
+
+        st.available -= std::chrono::duration_cast<std::chrono::nanoseconds>(
+            clock::now() - start).count();
+    }
+};
+
+template <std::uint64_t Micros>
+constexpr std::int64_t budget_option<Micros>::capacity;
+
+} // namespace detail
+
+/***************************************************************************/
+
+inline
+budget_report get_budget_report() {
+    return detail::budget_report_holder<>::current();
+}
+
+} // namespace contract
+
+/***************************************************************************/
+
+#endif // __contract_budget_hpp__included
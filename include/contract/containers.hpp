@@ -0,0 +1,480 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef __contract_containers_hpp__included
+#define __contract_containers_hpp__included
+
+/***************************************************************************/
+
+#include <contract/contract.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/***************************************************************************/
+
+// interface: macros
+//
+
+// Define invariant that a range doesn't change.
+//
+// This macro defines an invariant check for a `fun`, `mfun`, `ctor` or `dtor`
+// contract block: the contents of `range` on exit must be the same as on
+// entry.  A checksum of the range is taken on entry and compared on exit, so
+// the range is never copied.  For <checked_vector> and <checked_map> the
+// checksum is maintained incrementally and both steps are O(1); other ranges
+// are hashed element by element.  A contract block can check at most
+// `CONTRACT_SNAPSHOT_SLOTS` ranges; further ones are not checked.  Outside of
+// function contract blocks the check does nothing.
+//
+// @range  container or range of hashable elements, or a <checked_vector> or a
+//         <checked_map>.
+//
+// Use macro `CONTRACT_DISABLE_INVARIANTS` to disable invariant checking.
+#if !defined(CONTRACT_DISABLE_INVARIANTS) && !defined(CONTRACT_ASSUME_INVARIANTS)
+#	define INVARIANT_UNCHANGED(range) \
+        __ct_contract_unchanged__(invariant, range)
+#else
+#	define INVARIANT_UNCHANGED(range) \
+        do {} while (false && ::contract::checksum(range))
+#endif
+
+// implementation: macros
+//
+
+#if !defined(__ct_quick_enforce__)
+
+// Unchanged range check implementation: snapshot on the entry pass, compare
+// on the exit pass if the snapshot was taken.
+#define __ct_contract_unchanged__(TYPE, RANGE) \
+    do { \
+        ::contract::detail::snapshot * contract_snapshot__ = contract_context__.next_snapshot(); \
+        if (contract_policy__::TYPE ## s && contract_snapshot__) { \
+            if (contract_context__.entry) { \
+                contract_snapshot__->taken = contract_context__.take_snapshots; \
+                if (contract_snapshot__->taken) \
+                    contract_snapshot__->value = ::contract::checksum(RANGE); \
+            } else if (contract_snapshot__->taken && contract_context__.check_ ## TYPE() \
+                && __ct_site_enabled__("unchanged(" #RANGE ")")) { \
+                if (::contract::detail::check_probe<contract_policy__> contract_probe__{ \
+                        __ct_check_site__(TYPE, "unchanged(" #RANGE ")")}) { \
+                    if (contract_snapshot__->value != ::contract::checksum(RANGE) \
+                        || __ct_inject_fault__(__ct_check_site__(TYPE, "unchanged(" #RANGE ")"))) \
+                        contract_policy__::handle( \
+                            ::contract::violation_context( \
+                                ::contract::type::TYPE \
+                                ,#RANGE " changed" \
+                                ,"unchanged(" #RANGE ")" \
+                                ,__FILE__ \
+                                ,__LINE__ \
+                                ,__ct_site_id__("unchanged(" #RANGE ")") \
+                            ) \
+                        ); \
+                } \
+            } \
+        } \
+    } while (0)
+
+#else // __ct_quick_enforce__
+
+// Quick-enforce unchanged range check implementation.
+#define __ct_contract_unchanged__(TYPE, RANGE) \
+    do { \
+        ::contract::detail::snapshot * contract_snapshot__ = contract_context__.next_snapshot(); \
+        if (contract_policy__::TYPE ## s && contract_snapshot__) { \
+            if (contract_context__.entry) { \
+                contract_snapshot__->taken = contract_context__.take_snapshots; \
+                if (contract_snapshot__->taken) \
+                    contract_snapshot__->value = ::contract::checksum(RANGE); \
+            } else if (contract_snapshot__->taken && contract_context__.check_ ## TYPE() \
+                && __ct_site_enabled__("unchanged(" #RANGE ")") \
+                && contract_snapshot__->value != ::contract::checksum(RANGE)) { \
+                __ct_trap__(); \
+            } \
+        } \
+    } while (0)
+
+#endif // __ct_quick_enforce__
+
+/***************************************************************************/
+
+namespace contract {
+namespace detail {
+
+// implementation: checksums
+//
+
+// Finalizer of the SplitMix64 generator; spreads the bits of a hash.
+inline
+std::uint64_t checksum_mix(std::uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+template <typename T>
+std::uint64_t element_hash(T const & value) {
+    return std::hash<T>{}(value);
+}
+
+template <typename First, typename Second>
+std::uint64_t element_hash(std::pair<First, Second> const & value) {
+    return checksum_mix(element_hash(value.first)) + element_hash(value.second);
+}
+
+// Checksum term of the element with hash `hash` at the position `pos` of a
+// sequence.  The checksum of a sequence is the sum of its terms.
+inline
+std::uint64_t sequence_term(std::size_t pos, std::uint64_t hash) {
+    return checksum_mix(hash + pos * 0x9e3779b97f4a7c15ull);
+}
+
+template <typename Range>
+auto checksum(Range const & range, int) -> decltype(range.checksum()) {
+    return range.checksum();
+}
+
+template <typename Range>
+std::uint64_t checksum(Range const & range, long) {
+    std::uint64_t sum = 0;
+    std::size_t pos = 0;
+
+    for (auto const & value: range)
+        sum += sequence_term(pos++, element_hash(value));
+
+    return sum;
+}
+
+} // namespace detail
+
+// interface: checksums
+//
+
+// Compute the checksum of a range.
+//
+// Ranges with the same elements in the same order have the same checksum.
+//
+// @range    <checked_vector>, <checked_map>, or a range of elements hashable
+//           with `std::hash` (or pairs of such elements).
+// @returns  the checksum; O(1) for checked containers, O(n) otherwise.
+template <typename Range>
+std::uint64_t checksum(Range const & range) {
+    return detail::checksum(range, 0);
+}
+
+// interface: checked containers
+//
+
+// Vector that maintains a checksum of its elements across mutations.
+//
+// Elements can only be changed through the member functions of the vector, so
+// the checksum always matches the elements, also after a change that threw.  Appending, removing the last
+// element and replacing an element update the checksum in O(1); inserting and
+// erasing update it in O(n) of the elements after the position.
+template <typename T, typename Allocator = std::allocator<T>>
+class checked_vector {
+public:
+    using container_type  = std::vector<T, Allocator>;
+    using value_type      = T;
+    using size_type       = typename container_type::size_type;
+    using const_reference = typename container_type::const_reference;
+    using const_iterator  = typename container_type::const_iterator;
+
+    checked_vector()
+        :sum_{0}
+    {}
+
+    explicit
+    checked_vector(container_type values)
+        :values_(std::move(values))
+        ,sum_{terms(0, values_.size())}
+    {}
+
+    checked_vector(std::initializer_list<T> values)
+        :values_(values)
+        ,sum_{terms(0, values_.size())}
+    {}
+
+    std::uint64_t checksum() const { return sum_; }
+
+    container_type const & container() const { return values_; }
+
+    size_type size() const { return values_.size(); }
+    bool empty() const { return values_.empty(); }
+    size_type capacity() const { return values_.capacity(); }
+
+    const_reference operator[](size_type pos) const { return values_[pos]; }
+    const_reference at(size_type pos) const { return values_.at(pos); }
+    const_reference front() const { return values_.front(); }
+    const_reference back() const { return values_.back(); }
+    T const * data() const { return values_.data(); }
+
+    const_iterator begin() const { return values_.begin(); }
+    const_iterator end() const { return values_.end(); }
+
+    void reserve(size_type n) { values_.reserve(n); }
+
+    void push_back(T value) {
+        values_.push_back(std::move(value));
+        sum_ += term(values_.size() - 1);
+    }
+
+    template <typename ...Args>
+    void emplace_back(Args && ...args) {
+        values_.emplace_back(std::forward<Args>(args)...);
+        sum_ += term(values_.size() - 1);
+    }
+
+    void pop_back() {
+        sum_ -= term(values_.size() - 1);
+        values_.pop_back();
+    }
+
+    // Replace the element at `pos` with `value`.
+    void set(size_type pos, T value) {
+        modify(pos, [&value](T & elem) { elem = std::move(value); });
+    }
+
+    // Change the element at `pos` in place by calling `f(element)`.  If `f`
+    // throws, the checksum matches what it left of the element.
+    template <typename Func>
+    void modify(size_type pos, Func f) {
+        rehash update{*this, pos, 1};
+        f(values_[pos]);
+    }
+
+    const_iterator insert(const_iterator where, T value) {
+        size_type const pos = where - values_.begin();
+        {
+            rehash update{*this, pos, size_type(-1)};
+            values_.insert(values_.begin() + pos, std::move(value));
+        }
+        return values_.begin() + pos;
+    }
+
+    const_iterator erase(const_iterator where) {
+        size_type const pos = where - values_.begin();
+        {
+            rehash update{*this, pos, size_type(-1)};
+            values_.erase(values_.begin() + pos);
+        }
+        return values_.begin() + pos;
+    }
+
+    void clear() {
+        values_.clear();
+        sum_ = 0;
+    }
+
+private:
+    std::uint64_t term(size_type pos) const {
+        return detail::sequence_term(pos, detail::element_hash(values_[pos]));
+    }
+
+    // Sum of the terms of up to `count` elements from `from` on.
+    std::uint64_t terms(size_type from, size_type count) const {
+        size_type const to = count < values_.size() - from ? from + count : values_.size();
+
+        std::uint64_t sum = 0;
+        for (size_type pos = from; pos < to; ++pos)
+            sum += term(pos);
+        return sum;
+    }
+
+    // Takes the terms of up to `count` elements from `from` on out of the
+    // checksum, and adds the terms of the elements there then back when
+    // destroyed, so the checksum matches the elements even if the change in
+    // between throws.
+    class rehash {
+    public:
+        rehash(checked_vector & v, size_type from, size_type count)
+            :v_(v)
+            ,from_{from}
+            ,count_{count}
+        {
+            v_.sum_ -= v_.terms(from_, count_);
+        }
+
+        ~rehash() {
+            v_.sum_ += v_.terms(from_, count_);
+        }
+
+        rehash(rehash const &) = delete;
+        rehash & operator=(rehash const &) = delete;
+
+    private:
+        checked_vector & v_;
+        size_type const from_;
+        size_type const count_;
+    };
+
+    container_type values_;
+    std::uint64_t sum_;
+};
+
+// Map that maintains a checksum of its elements across mutations.
+//
+// Elements can only be changed through the member functions of the map, so
+// the checksum always matches the elements, also after a change that threw.  The checksum doesn't depend on
+// the order of the elements, and every mutation updates it in O(1) on top of
+// the cost of the map operation.
+template <typename Key,
+          typename T,
+          typename Compare = std::less<Key>,
+          typename Allocator = std::allocator<std::pair<Key const, T>>>
+class checked_map {
+public:
+    using container_type = std::map<Key, T, Compare, Allocator>;
+    using key_type       = Key;
+    using mapped_type    = T;
+    using value_type     = typename container_type::value_type;
+    using size_type      = typename container_type::size_type;
+    using const_iterator = typename container_type::const_iterator;
+
+    checked_map()
+        :sum_{0}
+    {}
+
+    explicit
+    checked_map(container_type values)
+        :values_(std::move(values))
+        ,sum_{0}
+    {
+        for (value_type const & value: values_)
+            sum_ += term(value);
+    }
+
+    checked_map(std::initializer_list<value_type> values)
+        :checked_map(container_type(values))
+    {}
+
+    std::uint64_t checksum() const { return sum_; }
+
+    container_type const & container() const { return values_; }
+
+    size_type size() const { return values_.size(); }
+    bool empty() const { return values_.empty(); }
+
+    const_iterator find(Key const & key) const { return values_.find(key); }
+    size_type count(Key const & key) const { return values_.count(key); }
+    T const & at(Key const & key) const { return values_.at(key); }
+
+    const_iterator begin() const { return values_.begin(); }
+    const_iterator end() const { return values_.end(); }
+
+    std::pair<const_iterator, bool> insert(value_type value) {
+        auto const result = values_.insert(std::move(value));
+        if (result.second)
+            sum_ += term(*result.first);
+        return result;
+    }
+
+    template <typename ...Args>
+    std::pair<const_iterator, bool> emplace(Args && ...args) {
+        auto const result = values_.emplace(std::forward<Args>(args)...);
+        if (result.second)
+            sum_ += term(*result.first);
+        return result;
+    }
+
+    // Insert `value` under `key`, or replace the value already there.
+    void assign(Key const & key, T value) {
+        auto const it = values_.find(key);
+        if (it == values_.end())
+            insert(value_type(key, std::move(value)));
+        else
+            change(it, [&value](T & elem) { elem = std::move(value); });
+    }
+
+    // Change the value under `key` in place by calling `f(value)`.
+    //
+    // @returns  `false` if there is no value under `key`.
+    template <typename Func>
+    bool modify(Key const & key, Func f) {
+        auto const it = values_.find(key);
+        if (it == values_.end())
+            return false;
+
+        change(it, f);
+        return true;
+    }
+
+    size_type erase(Key const & key) {
+        auto const it = values_.find(key);
+        if (it == values_.end())
+            return 0;
+
+        erase(const_iterator(it));
+        return 1;
+    }
+
+    const_iterator erase(const_iterator where) {
+        sum_ -= term(*where);
+        return values_.erase(where);
+    }
+
+    void clear() {
+        values_.clear();
+        sum_ = 0;
+    }
+
+private:
+    static
+    std::uint64_t term(value_type const & value) {
+        return detail::checksum_mix(detail::element_hash(value));
+    }
+
+    // Changes the value at `it`; if `f` throws, the checksum matches what it
+    // left of the value.
+    template <typename Func>
+    void change(typename container_type::iterator it, Func f) {
+        rehash update{*this, it};
+        f(it->second);
+    }
+
+    // Takes the term of the element at an iterator out of the checksum, and
+    // adds its term back when destroyed, so the checksum matches the element
+    // even if the change in between throws.
+    class rehash {
+    public:
+        rehash(checked_map & m, typename container_type::iterator it)
+            :m_(m)
+            ,it_{it}
+        {
+            m_.sum_ -= term(*it_);
+        }
+
+        ~rehash() {
+            m_.sum_ += term(*it_);
+        }
+
+        rehash(rehash const &) = delete;
+        rehash & operator=(rehash const &) = delete;
+
+    private:
+        checked_map & m_;
+        typename container_type::iterator const it_;
+    };
+
+    container_type values_;
+    std::uint64_t sum_;
+};
+
+} // namespace contract
+
+/***************************************************************************/
+
+#endif // __contract_containers_hpp__included
@@ -11,288 +11,727 @@
 
 /***************************************************************************/
 
+#include <atomic>
 #include <cstddef>
-#include <iostream>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <exception>
 #include <functional>
+#include <memory>
 #include <type_traits>
+#include <utility>
 
 /***************************************************************************/
 
-#ifdef __GNUC__
-#  define __CT_UNUSED(x) x __attribute__((__unused__))
-#elif defined(_MSC_VER)
-#  define __CT_UNUSED(x) __pragma(warning(suppress:4100)) x
-#else
-#  define __CT_UNUSED(x) x
+#include <contract/macros.hpp>
+
+#if defined(__ct_compile_library__)
+#	include <iostream>
 #endif
 
-#define __ct_stringify_imp__(x) #x
-#define __ct_stringify__(x) stringify_imp__(x)
+/***************************************************************************/
 
-// macros for variadic argument dispatch
-#define __ct_arg_pos__(_1,_2,_3,_4,_5, N, ...) N
-#define __ct_arg_count__(...) __ct_arg_pos__(__VA_ARGS__, 5, 4, 3, 2, 1)
+__ct_export__ namespace contract {
 
-#define __ct_concat2__(macro, argc) macro ## argc
-#define __ct_concat__(macro, argc) __ct_concat2__(macro, argc)
+// interface: violation handler
+//
 
-/***************************************************************************/
+// Values for types of contract checks.
+//
+// Enumeration that defines the values for types of contract checks.  These
+// types correspond to the identically named contract check macros.  This
+// enumeration is not usable directly.  Instead, contract check macros pass the
+// appropriate enumeration value to the contractor of the <violation_context>
+// class.
+enum class type: std::uint8_t {
+     precondition
+    ,postcondition
+    ,invariant
+};
 
-#define CONTRACT_LIB_VERSION_MAJOR 0
-#define CONTRACT_LIB_VERSION_MINOR 2
-#define CONTRACT_LIB_VERSION_PATCH 3
+namespace detail {
 
-#define CONTRACT_LIB_VERSION_STRING \
-    __ct_stringify__(CONTRACT_LIB_VERSION_MAJOR) "." \
-    __ct_stringify__(CONTRACT_LIB_VERSION_MINOR) "." \
-    __ct_stringify__(CONTRACT_LIB_VERSION_PATCH)
+// Writer of text into a fixed caller-provided buffer.  It never allocates,
+// locks or calls into the C library, so it can be used on the violation path
+// under memory pressure and in signal handlers.  Output that doesn't fit is
+// dropped; the buffer is always NUL-terminated.
+class format_buffer {
+public:
+    format_buffer(char * buf, std::size_t size) noexcept
+        :buf_{buf}
+        ,size_{size}
+        ,used_{0}
+    {
+        if (size_ != 0)
+            buf_[0] = '\0';
+    }
 
-#define CONTRACT_LIB_VERSION \
-    CONTRACT_LIB_VERSION_MAJOR * 10000 + \
-    CONTRACT_LIB_VERSION_MINOR * 100 + \
-    CONTRACT_LIB_VERSION_PATCH
+    char const * c_str() const noexcept { return buf_; }
+    std::size_t size() const noexcept { return used_; }
 
-/***************************************************************************/
+    format_buffer & put(char c) noexcept {
+        if (used_ + 1 < size_) {
+            buf_[used_++] = c;
+            buf_[used_] = '\0';
+        }
+        return *this;
+    }
 
-// interface: macros
-//
+    format_buffer & put(char const * s) noexcept {
+        while (s && *s)
+            put(*s++);
+        return *this;
+    }
 
-// Define contract block.
-//
-// This macro defines a contract block for a specified `scope`.
-//
-// @scope  the scope of the contract:
-//             `fun`     - defines a free function contract,
-//             `mfun`    - defines a contract for a member-function,
-//             `ctor`    - defines a contract for a constructor,
-//             `dtor`    - defines a contract for a destructor,
-//             `loop`    - defines a loop invariant contract,
-//             `class`   - defines a contract for a class,
-//             `derived` - defines a contract for a derived class.
-#define CONTRACT(scope) __ct_contract_ ## scope ## __
-
-// Define precondition contract.
-//
-// This macro defines a precondition check for a contract block defined by the
-// `contract(...)` macro.  Precondition is checked in the following situations:
-//   `fun`   - on function entry,
-//   `mfun`  - on member-function entry,
-//   `ctor`  - on constructor entry,
-//   `dtor`  - on destructor entry,
-//   `loop`  - not checked.
-//
-// @cond  precondition expression that should evalate to `true`.
-// @msg   message which is reported to the contract violation handler if `cond`
-//        evaluates to `false`.
-//
-// Use macro `CONTRACT_DISABLE_PRECONDITIONS` to disable precondition checking.
-#define PRECONDITION(...) \
-    __ct_concat__(PRECONDITION, __ct_arg_count__(__VA_ARGS__))(__VA_ARGS__)
-#define PRECONDITION1(cond) PRECONDITION2(cond, #cond)
-
-#if !defined(CONTRACT_DISABLE_PRECONDITIONS)
-#	define PRECONDITION2(cond, msg) \
-        __ct_contract_check__(precondition, cond, msg)
-#else
-#	define PRECONDITION2(cond, msg) \
-        do {} while (false && (cond))
-#endif
+    format_buffer & put_unsigned(unsigned long long value, unsigned base = 10) noexcept {
+        char digits[64];
+        std::size_t n = 0;
 
-// Define postcondition contract.
-//
-// This macro defines a postcondition check for a contract block defined by the
-// `contract(...)` macro.  Precondition is checked in the following situations:
-//   `fun`   - on function exit,
-//   `mfun`  - on member-function exit,
-//   `ctor`  - on constructor exit,
-//   `dtor`  - on destructor exit,
-//   `loop`  - not checked.
-//
-// @cond  postcondition expression that should evalate to `true`.
-// @msg   message which is reported to the contract violation handler if `cond`
-//        evaluates to `false`.
-//
-// Use macro `CONTRACT_DISABLE_POSTCONDITIONS` to disable precondition checking.
-#define POSTCONDITION(...) \
-    __ct_concat__(POSTCONDITION, __ct_arg_count__(__VA_ARGS__))(__VA_ARGS__)
-#define POSTCONDITION1(cond) POSTCONDITION2(cond, #cond)
-
-#if !defined(CONTRACT_DISABLE_POSTCONDITIONS)
-#	define POSTCONDITION2(cond, msg) \
-        __ct_contract_check__(postcondition, cond, msg)
-#else
-#	define POSTCONDITION2(cond, msg) \
-        do {} while (false && (cond))
-#endif
+        do {
+            digits[n++] = "0123456789abcdef"[value % base];
+            value /= base;
+        } while (value != 0);
 
-// Define invariant contract.
-//
-// This macro defines an invariant check for a contract block defined by the
-// `contract(...)` macro.  Invariant is checked in the following situations:
-//   `fun`     - on function entry and exit,
-//   `mfun`    - on member-function entry and exit,
-//   `ctor`    - on constructor exit,
-//   `dtor`    - on destructor entry,
-//   `loop`    - on each loop iteration,
-//   `class`   - on entry and exit of each method with a `contract(this) block,
-//               on exit of constructors with a `contract(ctor)` block, unless
-//                  an exception is thrown,
-//               on entry to destructors with a `contract(dtor)` block,
-//   `derived` - on entry and exit of each method with a `contract(this) block,
-//               on exit of constructors with a `contract(ctor)` block unless
-//                  an exception is thrown,
-//               on entry to destructors with a `contract(dtor)` block.
-//
-// @cond  postcondition expression that should evalate to `true`.
-// @msg   message which is reported to the contract violation handler if `cond`
-//        evaluates to `false`.
+        while (n != 0)
+            put(digits[--n]);
+        return *this;
+    }
+
+    format_buffer & put_signed(long long value) noexcept {
+        if (value < 0) {
+            put('-');
+            return put_unsigned(0ull - static_cast<unsigned long long>(value));
+        }
+        return put_unsigned(static_cast<unsigned long long>(value));
+    }
+
+    // Six significant decimals, in scientific notation for very large and
+    // very small magnitudes.  Not correctly rounded, but close enough for
+    // diagnostics.
+    format_buffer & put_double(double value) noexcept {
+        if (value != value)
+            return put("nan");
+        if (value < 0) {
+            put('-');
+            value = -value;
+        }
+        if (value > 1.7976931348623157e308)
+            return put("inf");
+
+        int exponent = 0;
+        if (value >= 1e15) {
+            for (; value >= 10; ++exponent)
+                value /= 10;
+        } else if (value != 0 && value < 1e-4) {
+            for (; value < 1; --exponent)
+                value *= 10;
+        }
+
+        unsigned long long integral = static_cast<unsigned long long>(value);
+        unsigned long long fraction = static_cast<unsigned long long>(
+            (value - static_cast<double>(integral)) * 1e6 + 0.5);
+        if (fraction >= 1000000) {
+            ++integral;
+            fraction -= 1000000;
+        }
+
+        put_unsigned(integral);
+        if (fraction != 0) {
+            char digits[6];
+            int n = 6;
+            for (int i = 5; i >= 0; --i, fraction /= 10)
+                digits[i] = static_cast<char>('0' + fraction % 10);
+            while (digits[n - 1] == '0')
+                --n;
+
+            put('.');
+            for (int i = 0; i != n; ++i)
+                put(digits[i]);
+        }
+
+        if (exponent != 0)
+            put('e').put_signed(exponent);
+        return *this;
+    }
+
+private:
+    char * buf_;
+    std::size_t size_;
+    std::size_t used_;
+};
+
+// Compile-time contract check site ids.  Strings are hashed as a balanced
+// tree of their halves, so the constexpr recursion depth only grows with the
+// logarithm of the length.
+constexpr
+std::uint64_t site_mix(std::uint64_t h) {
+    return (h ^ (h >> 29)) * 0xbf58476d1ce4e5b9ull;
+}
+
+constexpr
+std::uint64_t site_hash(char const * s, std::size_t b, std::size_t e) {
+    return e - b == 0 ? 0
+         : e - b == 1 ? site_mix(static_cast<unsigned char>(s[b]) + 0x100ull)
+         : site_mix(site_hash(s, b, b + (e - b) / 2) * 0x9e3779b97f4a7c15ull
+                    + site_hash(s, b + (e - b) / 2, e));
+}
+
+template <std::size_t File, std::size_t Cond>
+constexpr
+std::uint64_t site_id(char const (&file)[File], std::size_t line, char const (&cond)[Cond]) {
+    return site_mix(site_hash(file, 0, File - 1) * 31
+                    + site_mix(line) * 7
+                    + site_hash(cond, 0, Cond - 1)) | 1;
+}
+
+// The site id `Id` as a constant, see `__ct_site_id__`.
+template <std::uint64_t Id>
+using site_constant = std::integral_constant<std::uint64_t, Id>;
+
+// Whether `T` is a contiguous range of characters, like `std::string`.
+template <typename T, typename = void>
+struct is_char_range: std::false_type {};
+
+template <typename T>
+struct is_char_range<T, typename std::enable_if<
+    std::is_convertible<decltype(std::declval<T const &>().data()), char const *>::value
+    && std::is_convertible<decltype(std::declval<T const &>().size()), std::size_t>::value
+>::type>: std::true_type {};
+
+} // namespace detail
+
+// Operand value captured by a failed comparison check.
 //
-// Use macro `CONTRACT_DISABLE_INVARIANTS` to disable precondition checking.
-#define INVARIANT(...) \
-    __ct_concat__(INVARIANT, __ct_arg_count__(__VA_ARGS__))(__VA_ARGS__)
-#define INVARIANT1(cond) INVARIANT2(cond, #cond)
-
-#if !defined(CONTRACT_DISABLE_INVARIANTS)
-#	define INVARIANT2(cond, msg) \
-        __ct_contract_check__(invariant, cond, msg)
-#else
-#	define INVARIANT2(cond, msg) \
-        do {} while (false && (cond))
+// Comparison checks like `PRECONDITION_EQ(a, b)` capture the values of their
+// operands into the <violation_context>.  Arithmetic values, characters,
+// booleans, enumerations and pointers are stored as is; strings (pointers to
+// `char`, character arrays and ranges like `std::string`) are copied into an
+// inline buffer of `CONTRACT_CAPTURE_TEXT_SIZE - 1` characters and truncated
+// if longer.  Values of other types are not captured.  Capturing and
+// formatting never allocate.
+class captured_value {
+public:
+    enum class kind: std::uint8_t {
+         none        // not captured
+        ,boolean
+        ,character
+        ,signed_integer
+        ,unsigned_integer
+        ,floating
+        ,pointer
+        ,text
+    };
+
+    captured_value() noexcept
+        :kind_{kind::none}
+        ,truncated_{false}
+    {}
+
+    template <typename T>
+    explicit
+    captured_value(T const & value) noexcept
+        :kind_{kind::none}
+        ,truncated_{false}
+    {
+        capture(value, 0);
+    }
+
+    kind get_kind() const noexcept { return kind_; }
+
+    // Whether a captured string was longer than the inline buffer.
+    bool truncated() const noexcept { return truncated_; }
+
+    // Copy the raw value into `buf`: the native representation of a scalar,
+    // or the characters of a string without the NUL.
+    //
+    // @returns  the number of bytes copied, at most `size`.
+    std::size_t copy_bytes(unsigned char * buf, std::size_t size) const noexcept {
+        void const * data = &signed_;
+        std::size_t n = 0;
+
+        switch (kind_) {
+            case kind::none:
+                break;
+            case kind::boolean:
+                data = &boolean_;
+                n = sizeof(boolean_);
+                break;
+            case kind::character:
+                data = &character_;
+                n = sizeof(character_);
+                break;
+            case kind::signed_integer:
+            case kind::unsigned_integer:
+            case kind::floating:
+                n = 8;
+                break;
+            case kind::pointer:
+                data = &pointer_;
+                n = sizeof(pointer_);
+                break;
+            case kind::text:
+                data = text_;
+                n = std::strlen(text_);
+                break;
+        }
+
+        if (n > size)
+            n = size;
+        std::memcpy(buf, data, n);
+        return n;
+    }
+
+    // Rebuild a value of kind `k` from the bytes copied by <copy_bytes>.
+    static
+    captured_value from_bytes(kind k,
+                              unsigned char const * data,
+                              std::size_t size,
+                              bool truncated = false) noexcept {
+        captured_value value;
+        unsigned char * raw = reinterpret_cast<unsigned char *>(&value.signed_);
+
+        if (k == kind::text) {
+            value.capture_text(reinterpret_cast<char const *>(data), size, true);
+            value.truncated_ = value.truncated_ || truncated;
+        } else if (size <= 8) {
+            value.kind_ = k;
+            value.signed_ = 0;
+            std::memcpy(raw, data, size);
+        }
+
+        return value;
+    }
+
+    // Format the value into `buf`.
+    //
+    // @buf      buffer of `size` characters; the result is NUL-terminated and
+    //           truncated if it doesn't fit.
+    // @returns  the number of characters written, without the NUL.
+    std::size_t format(char * buf, std::size_t size) const noexcept {
+        detail::format_buffer out{buf, size};
+
+        switch (kind_) {
+            case kind::none:
+                out.put('?');
+                break;
+            case kind::boolean:
+                out.put(boolean_ ? "true" : "false");
+                break;
+            case kind::character:
+                out.put('\'').put(character_).put('\'');
+                break;
+            case kind::signed_integer:
+                out.put_signed(signed_);
+                break;
+            case kind::unsigned_integer:
+                out.put_unsigned(unsigned_);
+                break;
+            case kind::floating:
+                out.put_double(floating_);
+                break;
+            case kind::pointer:
+                if (pointer_)
+                    out.put("0x").put_unsigned(
+                        reinterpret_cast<std::uintptr_t>(pointer_), 16);
+                else
+                    out.put("nullptr");
+                break;
+            case kind::text:
+                out.put('"').put(text_).put(truncated_ ? "\"..." : "\"");
+                break;
+        }
+
+        return out.size();
+    }
+
+private:
+    // `int` overloads are preferred to the `long` fallback.
+    template <typename T>
+    typename std::enable_if<std::is_same<T, bool>::value>::type
+    capture(T value, int) noexcept {
+        kind_ = kind::boolean;
+        boolean_ = value;
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_same<T, char>::value>::type
+    capture(T value, int) noexcept {
+        kind_ = kind::character;
+        character_ = value;
+    }
+
+    template <typename T>
+    typename std::enable_if<
+        (std::is_integral<T>::value && std::is_signed<T>::value
+            && !std::is_same<T, char>::value)
+        || std::is_enum<T>::value
+    >::type
+    capture(T value, int) noexcept {
+        kind_ = kind::signed_integer;
+        signed_ = static_cast<long long>(value);
+    }
+
+    template <typename T>
+    typename std::enable_if<
+        std::is_integral<T>::value && std::is_unsigned<T>::value
+        && !std::is_same<T, bool>::value && !std::is_same<T, char>::value
+    >::type
+    capture(T value, int) noexcept {
+        kind_ = kind::unsigned_integer;
+        unsigned_ = static_cast<unsigned long long>(value);
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value>::type
+    capture(T value, int) noexcept {
+        kind_ = kind::floating;
+        floating_ = static_cast<double>(value);
+    }
+
+    template <typename T>
+    typename std::enable_if<
+        std::is_pointer<T>::value
+        && std::is_object<typename std::remove_pointer<T>::type>::value
+        && !std::is_same<typename std::remove_cv<
+            typename std::remove_pointer<T>::type>::type, char>::value
+    >::type
+    capture(T value, int) noexcept {
+        kind_ = kind::pointer;
+        pointer_ = const_cast<void const *>(static_cast<void const volatile *>(value));
+    }
+
+    void capture(std::nullptr_t, int) noexcept {
+        kind_ = kind::pointer;
+        pointer_ = nullptr;
+    }
+
+    void capture(char const * value, int) noexcept {
+        if (value)
+            capture_text(value, static_cast<std::size_t>(-1));
+        else
+            capture(nullptr, 0);
+    }
+
+    template <typename T>
+    typename std::enable_if<detail::is_char_range<T>::value>::type
+    capture(T const & value, int) noexcept {
+        capture_text(value.data(), value.size(), true);
+    }
+
+    template <typename T>
+    void capture(T const &, long) noexcept {}
+
+    // Copy at most `size` characters of `text`, stopping at the first NUL
+    // unless `counted`.
+    void capture_text(char const * text, std::size_t size, bool counted = false) noexcept {
+        std::size_t n = 0;
+        for (; n != size && (counted || text[n] != '\0'); ++n) {
+            if (n == sizeof(text_) - 1) {
+                truncated_ = true;
+                break;
+            }
+            text_[n] = text[n];
+        }
+
+        kind_ = kind::text;
+        text_[n] = '\0';
+    }
+
+    kind kind_;
+    bool truncated_;
+    union {
+        bool boolean_;
+        char character_;
+        long long signed_;
+        unsigned long long unsigned_;
+        double floating_;
+        void const * pointer_;
+        char text_[CONTRACT_CAPTURE_TEXT_SIZE];
+    };
+};
+
+namespace detail {
+
+// Formatted contract messages.  A format string is checked at compile time:
+// `{}` stands for the next argument, `{{` and `}}` for braces.
+enum: std::size_t { bad_message_format = ~std::size_t{0} };
+
+// Number of `{}` placeholders in the format string `s`, <bad_message_format>
+// if it is malformed.
+constexpr
+std::size_t message_placeholders(char const * s, std::size_t n = 0) {
+    return s[0] == '\0' ? n
+         : s[0] == '{' && s[1] == '{' ? message_placeholders(s + 2, n)
+         : s[0] == '}' && s[1] == '}' ? message_placeholders(s + 2, n)
+         : s[0] == '{' && s[1] == '}' ? message_placeholders(s + 2, n + 1)
+         : s[0] == '{' || s[0] == '}' ? bad_message_format
+         : message_placeholders(s + 1, n);
+}
+
+// Number of message arguments; only used unevaluated.
+template <typename ...Args>
+std::integral_constant<std::size_t, sizeof...(Args)> message_arguments(Args const & ...);
+
+// Message passed to a contract check: a string that outlives the check, or
+// a message formatted into the per-thread buffer, which the
+// <violation_context> copies.
+struct message_text {
+    message_text(char const * t) noexcept
+        : text{t}
+        , formatted{false}
+    {}
+
+    message_text(char const * t, bool f) noexcept
+        : text{t}
+        , formatted{f}
+    {}
+
+    char const * text;
+    bool formatted;
+};
+
+// Holder for the buffer of the last formatted message of each thread.
+// Templated with a dummy type to be able to keep it in the header file.
+template <typename = void>
+struct message_holder {
+    static
+    char * buffer() noexcept {
+        static thread_local char text[CONTRACT_MESSAGE_SIZE];
+        return text;
+    }
+};
+
+// The module interface defines the buffer once, see src/contract.cppm.
+#if defined(CONTRACT_MODULE_INTERFACE)
+extern template struct message_holder<void>;
 #endif
 
-/***************************************************************************/
+// Formats a message with `Placeholders` placeholders from `Arguments`
+// arguments, which are checked to match.  Strings and characters are written
+// as they are, other values like captured operands (see <captured_value>).
+template <std::size_t Placeholders, std::size_t Arguments>
+struct message_format {
+    static_assert(Placeholders != bad_message_format,
+                  "malformed contract message format: use {} for arguments, "
+                  "{{ and }} for braces");
+    static_assert(Placeholders == Arguments,
+                  "the number of contract message arguments doesn't match "
+                  "the number of {} in the format");
+
+    template <typename ...Args>
+    static
+    message_text format(char const * fmt, Args const & ...args) noexcept {
+        format_buffer out{message_holder<>::buffer(), CONTRACT_MESSAGE_SIZE};
+        format_next(out, fmt, args...);
+        return {out.c_str(), true};
+    }
 
-// implementation: macros
-//
+private:
+    // Copy `fmt` up to the next placeholder; returns the rest or `nullptr`.
+    static
+    char const * copy(format_buffer & out, char const * fmt) noexcept {
+        for (; *fmt; ++fmt) {
+            if (fmt[0] == '{' && fmt[1] == '}')
+                return fmt + 2;
+            if (fmt[0] == fmt[1] && (fmt[0] == '{' || fmt[0] == '}'))
+                ++fmt;
+            out.put(*fmt);
+        }
+        return nullptr;
+    }
 
-// Define contract for a free function.
-#define __ct_contract_fun__ \
-    auto contract_obj__ = ::contract::detail::contractor<void *>(0) \
-    + [&](::contract::detail::contract_context const & __CT_UNUSED(contract_context__))
-
-// Define contract for a member function.
-#define __ct_contract_mfun__ \
-    auto contract_obj__ = ::contract::detail::contractor< \
-        std::remove_reference<decltype(*this)>::type \
-    >(this) \
-    + [&](::contract::detail::contract_context const & __CT_UNUSED(contract_context__))
-
-// Define contract for a constructor.
-#define __ct_contract_ctor__ \
-    auto contract_obj__ = ::contract::detail::contractor< \
-        std::remove_reference<decltype(*this)>::type \
-    >(this, false, true) \
-    + [&](::contract::detail::contract_context const & __CT_UNUSED(contract_context__))
-
-// Define contract for a destructor.
-#define __ct_contract_dtor__ \
-    auto contract_obj__ = ::contract::detail::contractor< \
-        std::remove_reference<decltype(*this)>::type \
-    >(this, true, false) \
-    + [&](::contract::detail::contract_context const & __CT_UNUSED(contract_context__))
-
-// Define a class contract.
-#define __ct_contract_class__ \
-    template <typename T> \
-    friend struct ::contract::detail::class_contract_base; \
-    \
-    template <typename T> \
-    friend struct ::contract::detail::has_class_contract; \
-    \
-    template <typename ...Bases> \
-    friend struct ::contract::detail::base_class_contract; \
-    \
-    ::contract::detail::contract_context prepare_contract__( \
-        ::contract::detail::contract_context const & __CT_UNUSED(contract_context__)) const \
-    { \
-        return contract_context__; \
-    } \
-    \
-    void class_contract__(::contract::detail::contract_context const & __CT_UNUSED(contract_context__)) const
-
-// Define a derived class contract.
-#define __ct_contract_derived__(...) \
-    template <typename T> \
-    friend struct ::contract::detail::class_contract_base; \
-    \
-    template <typename T> \
-    friend struct ::contract::detail::has_class_contract; \
-    \
-    template <typename ...Bases> \
-    friend struct ::contract::detail::base_class_contract; \
-    \
-    ::contract::detail::contract_context prepare_contract__( \
-        ::contract::detail::contract_context const & __CT_UNUSED(contract_context__)) const \
-    { \
-        ::contract::detail::base_class_contract<__VA_ARGS__>::enforce(this, contract_context__); \
-        return contract_context__; \
-    } \
-    \
-    void class_contract__(::contract::detail::contract_context const & __CT_UNUSED(contract_context__)) const
-
-
-// Define a loop invariant contract.
-#define __ct_contract_loop__ \
-    if (::contract::detail::contract_context contract_context__{false, false, true})
-
-// Contract check main implementation.
-#define __ct_contract_check__(TYPE, COND, MSG) \
-    do { \
-        if (contract_context__.check_ ## TYPE() && !(COND)) \
-            ::contract::handle_violation( \
-                ::contract::violation_context( \
-                    ::contract::type::TYPE \
-                    ,MSG \
-                    ,#COND \
-                    ,__FILE__ \
-                    ,__LINE__ \
-                ) \
-            ); \
-    } while (0)
+    static
+    void format_next(format_buffer & out, char const * fmt) noexcept {
+        copy(out, fmt);
+    }
 
-/***************************************************************************/
+    template <typename Arg, typename ...Args>
+    static
+    void format_next(format_buffer & out, char const * fmt,
+                     Arg const & arg, Args const & ...args) noexcept {
+        fmt = copy(out, fmt);
+        put(out, arg, 0);
+        format_next(out, fmt, args...);
+    }
 
-namespace contract {
+    // `int` overloads are preferred to the `long` fallback.
+    static
+    void put(format_buffer & out, char const * value, int) noexcept {
+        out.put(value ? value : "nullptr");
+    }
 
-// interface: violation handler
-//
+    template <typename T>
+    static
+    typename std::enable_if<std::is_same<T, char>::value>::type
+    put(format_buffer & out, T value, int) noexcept {
+        out.put(value);
+    }
 
-// Values for types of contract checks.
+    template <typename T>
+    static
+    typename std::enable_if<is_char_range<T>::value>::type
+    put(format_buffer & out, T const & value, int) noexcept {
+        char const * data = value.data();
+        for (std::size_t i = 0, size = value.size(); i != size; ++i)
+            out.put(data[i]);
+    }
+
+    template <typename T>
+    static
+    void put(format_buffer & out, T const & value, long) noexcept {
+        char text[2 * CONTRACT_CAPTURE_TEXT_SIZE];
+        captured_value{value}.format(text, sizeof(text));
+        out.put(text);
+    }
+};
+
+} // namespace detail
+
+// Static description of a contract check.
 //
-// Enumeration that defines the values for types of contract checks.  These
-// types correspond to the identically named contract check macros.  This
-// enumeration is not usable directly.  Instead, contract check macros pass the
-// appropriate enumeration value to the contractor of the <violation_context>
-// class.
-enum class type: std::uint8_t {
-     precondition
-    ,postcondition
-    ,invariant
+// Contract check macros pass it to the `count` member of their policy (see
+// <default_policy>) every time the check is evaluated.  All of its members
+// are compile-time constants.  It converts to the <contract::type> of the
+// check, so policies can also take just the type.
+struct check_site {
+    std::uint64_t id;             // site id of the check, see <violation_context>
+    contract::type contract_type; // type of the contract check macro
+    char const * file;            // file in which the contract check occurs
+    std::size_t line;             // line on which the contract check occurs
+    char const * condition;       // condition of the contract check
+
+    constexpr operator contract::type() const { return contract_type; }
 };
 
+// Level at which a contract check is evaluated.
+enum class site_level {
+     always    // whenever its contract block is evaluated
+    ,sampled   // in one of `rate` of those times on each thread
+    ,audit     // only in builds with `CONTRACT_AUDIT` defined
+};
+
+struct always_site {
+    static constexpr site_level level = site_level::always;
+    static constexpr std::uint64_t rate = 1;
+};
+
+template <std::uint64_t Rate>
+struct sampled_site {
+    static_assert(Rate != 0, "the sampling rate can't be 0");
+
+    static constexpr site_level level = site_level::sampled;
+    static constexpr std::uint64_t rate = Rate;
+};
+
+struct audit_site {
+    static constexpr site_level level = site_level::audit;
+    static constexpr std::uint64_t rate = 1;
+};
+
+// Level of the contract check with the site id `Site` (see
+// <violation_context>).
+//
+// Every check is evaluated at the `always` level unless the header named by
+// `CONTRACT_SITE_CONFIG` specializes this template for its site id, deriving
+// from <sampled_site> or <audit_site>.  The header is generated by the
+// `contract-pgo` tool from the evaluation counts of <contract/metrics.hpp>,
+// so the levels chosen from production runs are compiled in as constants.  Site ids
+// change with the file, line or condition of a check, so checks that were
+// moved or edited since are evaluated at the `always` level again.  Deferred
+// loop invariants are always evaluated.
+template <std::uint64_t Site>
+struct site_config: always_site {};
+
 // Context of the contract violation.
 //
 // Defines the context data passed to the <handle_violation> function when a
-// contract check macro detects a contract violation.
+// contract check macro detects a contract violation.  Every contract check
+// macro has a site id computed at compile time from its file, line and
+// condition (see `__ct_site_id__`), which identifies the check in logs and
+// metrics without its strings.  Comparison checks like
+// `PRECONDITION_EQ(a, b)` also capture the values of their operands into `lhs`
+// and `rhs`; for other checks these are not captured.  The context refers to
+// no heap memory.  A formatted message is copied from the per-thread buffer
+// into the context, so copies of the context, e.g. in exceptions rethrown on
+// another thread, keep it after the thread formats its next message.  Other
+// messages are not copied.
 struct violation_context {
     violation_context(contract::type t,
-                        char const * m,
+                        detail::message_text m,
                         char const * c,
                         char const * f,
-                        std::size_t l)
+                        std::size_t l,
+                        std::uint64_t s = 0)
         : contract_type{t}
-        , message{m}
+        , message{m.text}
         , condition{c}
         , file{f}
         , line{l}
-    {}
+        , site{s}
+    {
+        if (m.formatted)
+            copy_message(m.text);
+    }
+
+    violation_context(contract::type t,
+                        detail::message_text m,
+                        char const * c,
+                        char const * f,
+                        std::size_t l,
+                        captured_value const & lv,
+                        captured_value const & rv,
+                        std::uint64_t s = 0)
+        : contract_type{t}
+        , message{m.text}
+        , condition{c}
+        , file{f}
+        , line{l}
+        , site{s}
+        , lhs{lv}
+        , rhs{rv}
+    {
+        if (m.formatted)
+            copy_message(m.text);
+    }
+
+    violation_context(violation_context const & other) noexcept
+        : contract_type{other.contract_type}
+        , message{other.message}
+        , condition{other.condition}
+        , file{other.file}
+        , line{other.line}
+        , site{other.site}
+        , lhs{other.lhs}
+        , rhs{other.rhs}
+        , iteration{other.iteration}
+    {
+        if (other.message == other.text_)
+            copy_message(other.text_);
+    }
 
     contract::type const contract_type; // type of the failed contract check macro
     char const * message;         // message passed to the contract check macro
     char const * condition;       // condition of the contract check
     char const * file;            // file in which the contract check occures
     std::size_t const line;             // line on which the contact check occures
+    std::uint64_t site;           // id of the contract check, 0 if unknown
+    captured_value lhs;           // left operand of a failed comparison check
+    captured_value rhs;           // right operand of a failed comparison check
+
+    // iteration of a failed `LOOP_INVARIANT(...)` check, <no_iteration> for
+    // other checks
+    std::uint64_t iteration = no_iteration;
+
+    enum: std::uint64_t { no_iteration = ~std::uint64_t{0} };
+
+private:
+    void copy_message(char const * text) noexcept {
+        std::memcpy(text_, text, std::strlen(text) + 1);
+        message = text_;
+    }
+
+    char text_[CONTRACT_MESSAGE_SIZE];  // owned copy of a formatted message
 };
 
 // Handle contract violation.
@@ -303,7 +742,7 @@ struct violation_context {
 // @context  the context data for the contract violation.
 // @returns  this function doesn't return; it can either call another
 //           `[[noreturn]]` function or exit via an exception.
-[[noreturn]]
+[[noreturn]] __ct_decl__
 void handle_violation(violation_context const & context);
 
 // Type alias for the contract violation handler function.
@@ -312,11 +751,13 @@ using violation_handler = std::function<void (violation_context const &)>;
 // Set contract violation handler.
 //
 // Set the handler function which is invoked when a contract violation is
-// detected by a contract check macro.
+// detected by a contract check macro.  The handler may be replaced while other
+// threads report violations; those keep the handler they have already started
+// to call alive until it returns.
 //
 // @new_handler  new handler function.
 // @returns      previous handler function.
-violation_handler set_handler(violation_handler new_handler);
+__ct_decl__ violation_handler set_handler(violation_handler new_handler);
 
 // Get current contract violation handler.
 //
@@ -324,7 +765,128 @@ violation_handler set_handler(violation_handler new_handler);
 // detect by a contract check macro.
 //
 // @returns  current contract violation handler function.
-violation_handler get_handler();
+__ct_decl__ violation_handler get_handler();
+
+// interface: contract policies
+//
+
+// Default contract policy.
+//
+// A contract policy is a type that controls at compile time how the contract
+// blocks and checks using it behave.  The policy is selected with the
+// `CONTRACT_POLICY(...)` macro and is found by the usual name lookup, so it can
+// be set for a namespace, for a class or for a class template instance.  A
+// policy has to provide the following static members:
+//   `preconditions`, `postconditions`, `invariants` - whether checks of the
+//       corresponding type exist at all; disabled checks are never evaluated,
+//   `sample()`  - called once per contract block evaluation; if it returns
+//       `false` the block is skipped for that call,
+//   `count(s)`  - called for every evaluated contract check with its
+//       <check_site> `s`, which also converts to the <contract::type>,
+//   `handle(c)` - called when a contract check is violated.  Unlike the
+//       handler installed with <set_handler> it is a plain static function; if
+//       it returns, the execution continues after the failed check.
+// and may provide:
+//   `nothrow`   - whether the contract blocks are `noexcept`: a violation is
+//       then enforced by `handle` alone, and an exception it throws terminates
+//       the program.  Functions and move constructors with such contracts can
+//       be declared `noexcept` without changing what they do on violations.
+//       Always `true` with `CONTRACT_NO_EXCEPTIONS`.
+//   `loop_iterations` - whether deferred loop invariants find the iteration
+//       they failed on (`true` if missing).  If `false`, they only fold a
+//       failure flag, which is cheaper than the iteration fold, and report
+//       <violation_context::no_iteration>.
+//   `check_probe` - a type constructed from the <check_site> before each
+//       evaluation of a contract check and destroyed after it; the check is
+//       skipped if the probe converts to `false`.  It replaces the call to
+//       `count`, so it calls `count` itself for the checks it lets through.
+//       Deferred loop invariants are not probed.
+//
+// Custom policies usually derive from this one and hide the members they need
+// to change.  The default policy checks everything and reports violations via
+// <handle_violation>.
+struct default_policy {
+    static constexpr bool preconditions  = true;
+    static constexpr bool postconditions = true;
+    static constexpr bool invariants     = true;
+
+#if defined(CONTRACT_NO_EXCEPTIONS)
+    static constexpr bool nothrow        = true;
+#else
+    static constexpr bool nothrow        = false;
+#endif
+
+    static bool sample() noexcept { return true; }
+
+    static void count(check_site const &) noexcept {}
+
+    [[noreturn]]
+    static void handle(violation_context const & context) {
+        handle_violation(context);
+    }
+};
+
+// Contract policy with all contract checks compiled out.
+struct unchecked_policy: default_policy {
+    static constexpr bool preconditions  = false;
+    static constexpr bool postconditions = false;
+    static constexpr bool invariants     = false;
+};
+
+// Contract policy that enables the selected types of contract checks.
+template <bool Pre, bool Post, bool Inv, typename Policy = default_policy>
+struct check_policy: Policy {
+    static constexpr bool preconditions  = Pre;
+    static constexpr bool postconditions = Post;
+    static constexpr bool invariants     = Inv;
+};
+
+// Contract policy whose contract blocks are `noexcept`.
+template <typename Policy = default_policy>
+struct nothrow_policy: Policy {
+    static constexpr bool nothrow = true;
+};
+
+// Contract policy of the module `Module` declared with `CONTRACT_MODULE(...)`.
+// Behaves as `Policy`, but is a distinct type for every module.
+template <typename Module, typename Policy>
+struct module_policy: Policy {
+    using module = Module;
+};
+
+// interface: suppression scopes
+//
+
+// Scope in which contract checks of the current thread are not evaluated.
+//
+// While a suppression scope exists, the contract blocks entered or left on
+// its thread skip the suppressed types of checks, as if the policy had them
+// disabled; other threads are not affected.  Scopes nest, and each restores
+// on destruction what was suppressed before it.  Meant for latency-critical
+// sections of threads that otherwise run with full contracts.  A check costs
+// a thread-local load per contract block while no scope exists.
+class suppress_scope {
+public:
+    // Suppress all contract checks.
+    suppress_scope() noexcept;
+
+    // Suppress the contract checks of type `t` only.
+    explicit
+    suppress_scope(type t) noexcept;
+
+    ~suppress_scope();
+
+    suppress_scope(suppress_scope const &) = delete;
+    suppress_scope & operator=(suppress_scope const &) = delete;
+
+    // Whether the contract checks of type `t` are suppressed on the current
+    // thread.
+    static
+    bool suppressed(type t) noexcept;
+
+private:
+    unsigned const previous_;
+};
 
 /***************************************************************************/
 
@@ -333,86 +895,429 @@ namespace detail {
 // implementation: code behind macros
 //
 
+// Whether an exception is propagating; `std::uncaught_exception` is deprecated
+// since C++17.
+inline
+bool unwinding() noexcept {
+#if defined(CONTRACT_NO_EXCEPTIONS)
+    return false;
+#elif defined(__cpp_lib_uncaught_exceptions)
+    return std::uncaught_exceptions() != 0;
+#else
+    return std::uncaught_exception();
+#endif
+}
+
+// Whether the contract blocks governed by `Policy` are `noexcept`: the
+// `nothrow` member of the policy, `false` if it has none.
+template <typename Policy, typename = void>
+struct is_nothrow_policy
+    :std::integral_constant<bool, default_policy::nothrow>
+{};
+
+template <typename Policy>
+struct is_nothrow_policy<Policy, decltype(void(Policy::nothrow))>
+    :std::integral_constant<bool, Policy::nothrow || default_policy::nothrow>
+{};
+
+// Whether the deferred loop invariants governed by `Policy` find the failed
+// iteration: the `loop_iterations` member of the policy, `true` if it has
+// none.
+template <typename Policy, typename = void>
+struct tracks_loop_iterations
+    :std::true_type
+{};
+
+template <typename Policy>
+struct tracks_loop_iterations<Policy, decltype(void(Policy::loop_iterations))>
+    :std::integral_constant<bool, Policy::loop_iterations>
+{};
+
+// Whether the contract check with the site id `Site` is evaluated at its
+// configured level this time.
+template <std::uint64_t Site>
+inline
+bool site_enabled() noexcept {
+    using config = site_config<Site>;
+
+    if (config::level == site_level::always)
+        return true;
+
+    if (config::level == site_level::audit) {
+#if defined(CONTRACT_AUDIT)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static thread_local std::uint64_t evaluations = 0;
+    return evaluations++ % config::rate == 0;
+}
+
+// Probe of the contract checks of policies without a `check_probe` member:
+// counts every check and lets it through.
+template <typename Policy>
+struct counting_probe {
+    explicit
+    counting_probe(check_site const & site) noexcept(noexcept(Policy::count(site))) {
+        Policy::count(site);
+    }
+
+    explicit constexpr operator bool() const noexcept { return true; }
+};
+
+template <typename Policy, typename = void>
+struct policy_probe {
+    using type = counting_probe<Policy>;
+};
+
+template <typename Policy>
+struct policy_probe<Policy, decltype(void(sizeof(typename Policy::check_probe)))> {
+    using type = typename Policy::check_probe;
+};
+
+// Probe wrapped around the contract checks governed by `Policy`: the
+// `check_probe` member of the policy, <counting_probe> if it has none.
+template <typename Policy>
+using check_probe = typename policy_probe<Policy>::type;
+
+// Holder for the types of contract checks suppressed on each thread, one bit
+// per <contract::type>.
+// Templated with a dummy type to be able to keep it in the header file.
+template <typename = void>
+struct suppress_holder {
+    static
+    unsigned & mask() noexcept {
+        static thread_local unsigned bits = 0;
+        return bits;
+    }
+};
+
+// The module interface defines the mask once, see src/contract.cppm.
+#if defined(CONTRACT_MODULE_INTERFACE)
+extern template struct suppress_holder<void>;
+#endif
+
+inline
+constexpr unsigned suppress_bit(type t) noexcept {
+    return 1u << static_cast<unsigned>(t);
+}
+
+// Value snapshot by a function contract block on entry and compared on exit.
+struct snapshot {
+    std::uint64_t value;
+    bool taken;         // whether `value` was taken on entry
+};
+
+// Snapshots of a function contract block.  Every evaluation of the block
+// takes the slots in the same order.
+struct snapshot_slots {
+    snapshot * next() {
+        return used_ != CONTRACT_SNAPSHOT_SLOTS ? &values_[used_++] : nullptr;
+    }
+
+    void rewind() { used_ = 0; }
+
+    snapshot values_[CONTRACT_SNAPSHOT_SLOTS];
+    std::size_t used_;
+};
+
+// Share of the invariant checks of a class contract block evaluated by one of
+// `count` tasks: the checks are numbered in the order the block reaches them,
+// and the task evaluates those whose number is `index` modulo `count`.
+struct check_slice {
+    bool take() { return next++ % count == index; }
+
+    std::size_t const index;
+    std::size_t const count;
+    std::size_t next;
+};
+
 // Context in which a contract check is done.  Controls which parts of the
-// contract are checked.
+// contract are checked; the types suppressed on the current thread by a
+// <suppress_scope> are not.  The entry pass of a function contract block
+// takes the snapshots of its unchanged checks unless invariants are
+// suppressed; the exit pass only compares the snapshots taken.  With a
+// <check_slice>, only the invariant checks of the slice are evaluated.
 struct contract_context {
-    contract_context(bool pre, bool post, bool inv)
-        : check_pre{pre}
-        , check_post{post}
-        , check_inv{inv}
+    contract_context(bool pre, bool post, bool inv, snapshot_slots * snapshots = nullptr)
+        :contract_context{pre, post, inv, snapshots, suppress_holder<>::mask()}
+    {}
+
+    contract_context(bool pre, bool post, bool inv, snapshot_slots * snapshots,
+                     unsigned suppressed, check_slice * part = nullptr)
+        : check_pre{pre && !(suppressed & suppress_bit(type::precondition))}
+        , check_post{post && !(suppressed & suppress_bit(type::postcondition))}
+        , check_inv{inv && !(suppressed & suppress_bit(type::invariant))}
+        , entry{pre}
+        , take_snapshots{pre && !(suppressed & suppress_bit(type::invariant))}
+        , slots{snapshots}
+        , slice{part}
     {}
 
     explicit
     operator bool() { return true; }
 
     bool check_precondition()  const { return check_pre; }
-    bool check_postcondition() const { return check_post && !std::uncaught_exception(); }
-    bool check_invariant()     const { return check_inv; }
+    bool check_postcondition() const { return check_post && !unwinding(); }
+    bool check_invariant()     const { return check_inv && (!slice || slice->take()); }
+
+    // Take the next snapshot slot, or null if there is none left (or none at
+    // all, outside of function contract blocks).
+    snapshot * next_snapshot() const { return slots ? slots->next() : nullptr; }
 
     bool const check_pre;
     bool const check_post;
     bool const check_inv;
+    bool const entry;           // entry pass of a function contract block
+    bool const take_snapshots;  // whether the entry pass takes snapshots
+    snapshot_slots * const slots;
+    check_slice * const slice;
 };
 
 // Performs the check for a function or method contract.  Parameterized with
 // `ContrFunc` functor defining the actual contract in terms of <precondition>,
 // <postcondition> and <invariant> macros.  Precondition is checked on function
 // entry, postcondition is checked on function exit, and invariant is checked
-// on both entry and exit unless specified otherwise.
-template <typename ContrFunc>
+// on both entry and exit unless specified otherwise.  Nothing is checked if
+// the `Policy` didn't sample this call.
+template <typename Policy, typename ContrFunc>
 struct fun_contract {
+    static constexpr bool nothrow = is_nothrow_policy<Policy>::value;
+
     explicit
-    fun_contract(ContrFunc f, bool enter = true, bool exit = true)
+    fun_contract(ContrFunc f, bool enter = true, bool exit = true,
+                 bool sampled = Policy::sample()) noexcept(nothrow)
         :contr_{f}
         ,exit_{exit}
+        ,sampled_{sampled}
     {
-        contr_(contract_context{true, false, enter});
+        if (sampled_) {
+            slots_.rewind();
+            contr_(contract_context{true, false, enter, &slots_});
+        }
     }
 
-    ~fun_contract() noexcept(false)
+    ~fun_contract() noexcept(nothrow)
     {
-        contr_(contract_context{false, true, exit_});
+        if (sampled_) {
+            slots_.rewind();
+            contr_(contract_context{false, true, exit_, &slots_});
+        }
     }
 
     ContrFunc contr_;
     bool const exit_;
+    bool const sampled_;
+    snapshot_slots slots_;
+};
+
+// Iteration number of a `LOOP_INVARIANT(...)` check.
+using loop_iteration = std::uint64_t;
+
+// Description of a `LOOP_INVARIANT(...)` check.
+struct loop_site {
+    check_site site;
+    char const * message;
+};
+
+// Evaluation option of class contracts, see <contract/deferred.hpp>.
+struct deferred_option;
+
+// Policy of the deferred loop contract blocks governed by `Policy` in the
+// `quick_enforce` semantic: a failure flag is folded and a violation traps.
+template <typename Policy>
+struct quick_enforce_policy: Policy {
+    static constexpr bool loop_iterations = false;
+
+    static void count(check_site const &) noexcept {}
+
+    [[noreturn]]
+    static void handle(violation_context const &) noexcept {
+        __ct_trap__();
+    }
+};
+
+// Loop contract block enclosing a loop, selected by the option.  `Base` is the
+// value of `__COUNTER__` at the block; its checks use the following values to
+// find their slots.
+template <typename Policy, typename Option, int Base>
+struct loop_contract;
+
+// Performs the checks for a deferred loop contract.  Each `LOOP_INVARIANT`
+// check folds whether it failed into its slot and, if the policy tracks
+// iterations, the smallest iteration number it failed on; the earliest
+// violation is reported once when the block ends.
+//
+// The folds are 32 bits wide and the iterations are compared signed, so they
+// vectorize with the baseline SIMD of the target (SSE2 on x86-64), which has
+// neither 64-bit nor unsigned vector comparisons.  The iteration number is
+// therefore folded modulo 2^31; the failure flag is folded apart from it, so
+// no failure is lost in longer loops.
+template <typename Policy, int Base>
+struct loop_contract<Policy, deferred_option, Base> {
+    static constexpr bool nothrow = is_nothrow_policy<Policy>::value;
+    static constexpr bool iterations = tracks_loop_iterations<Policy>::value;
+
+    using fold_type = std::uint32_t;
+
+    static constexpr fold_type holds_always = ~fold_type{0};
+    static constexpr std::int32_t no_iteration = 0x7fffffff;
+
+    loop_contract() noexcept {
+        for (std::size_t i = 0; i != CONTRACT_LOOP_CHECKS; ++i) {
+            held_[i] = holds_always;
+            failed_[i] = no_iteration;
+            sites_[i] = nullptr;
+        }
+    }
+
+    loop_contract(loop_contract const &) = delete;
+    loop_contract & operator=(loop_contract const &) = delete;
+
+    explicit
+    operator bool() const noexcept { return true; }
+
+    template <int Counter>
+    void check(std::uint64_t iteration, bool holds, loop_site const & site) noexcept {
+        static_assert(Counter - Base - 1 < CONTRACT_LOOP_CHECKS,
+                      "too many LOOP_INVARIANT checks in a loop contract block; "
+                      "increase CONTRACT_LOOP_CHECKS");
+
+        // all ones if the check holds; written without a branch or a select
+        // so the folds are plain vector reductions
+        fold_type const holding = fold_type{0} - static_cast<fold_type>(holds);
+        held_[Counter - Base - 1] &= holding;
+
+        if (iterations) {
+            std::int32_t & failed = failed_[Counter - Base - 1];
+            std::int32_t const now = static_cast<std::int32_t>(
+                (static_cast<fold_type>(iteration) | holding) & no_iteration);
+            failed = now < failed ? now : failed;
+        }
+
+        sites_[Counter - Base - 1] = &site;
+    }
+
+    ~loop_contract() noexcept(nothrow) {
+        if (suppress_scope::suppressed(type::invariant))
+            return;
+
+        std::size_t first = CONTRACT_LOOP_CHECKS;
+
+        for (std::size_t i = 0; i != CONTRACT_LOOP_CHECKS; ++i) {
+            if (!sites_[i])
+                continue;
+
+            Policy::count(sites_[i]->site);
+            if (held_[i] != holds_always
+                && (first == CONTRACT_LOOP_CHECKS || failed_[i] < failed_[first]))
+                first = i;
+        }
+
+        if (first != CONTRACT_LOOP_CHECKS && !unwinding()) {
+            check_site const & site = sites_[first]->site;
+            violation_context context{type::invariant, sites_[first]->message,
+                                      site.condition, site.file, site.line, site.id};
+            if (iterations)
+                context.iteration = failed_[first];
+            Policy::handle(context);
+        }
+    }
+
+    fold_type held_[CONTRACT_LOOP_CHECKS];
+    std::int32_t failed_[CONTRACT_LOOP_CHECKS];
+    loop_site const * sites_[CONTRACT_LOOP_CHECKS];
+};
+
+// List of types.
+template <typename ...Types>
+struct type_list {};
+
+// Gives class contract evaluation options access to the private members
+// defined by the class and derived class contract blocks.
+struct class_contract_access {
+    // List of the base classes enforced by the class contract of `T`.
+    template <typename T>
+    struct bases {
+        using type = typename T::contract_bases__;
+    };
+
+    // Check the class contract of `obj` without its base class contracts.
+    template <typename T>
+    static
+    void invariant(T const * obj, contract_context const & context) {
+        obj->class_contract__(context);
+    }
+};
+
+// Class contract evaluation option that checks the class invariant on the
+// spot.  Used for class contracts defined without an option.
+//
+// An evaluation option decides when and how the class invariant is checked:
+// its `evaluate` function is called on method entry (`exit` is `false`) and on
+// method exit (`exit` is `true`) with a `check` function that checks the class
+// invariant of an object, including its base class invariants.
+struct immediate_option {
+    template <typename T>
+    static
+    void evaluate(T const * obj, void (*check)(T const *), bool /*exit*/) {
+        check(obj);
+    }
 };
 
 // A base class that performs the check for a class contract.  Parameterized
 // with `ContrFunc` functor defining the actual contract in terms of
 // <precondition>, <postcondition> and <invariant> macros.  Precondition and
 // postcondition are not checked.  Invariant is checked on entry and exit if
-// specified.
-template <typename T>
+// specified, as decided by the evaluation option of the class contract.
+template <typename Policy, typename T>
 struct class_contract_base {
-    class_contract_base(T const * obj, bool enter, bool exit)
+    static constexpr bool nothrow = is_nothrow_policy<Policy>::value;
+
+    class_contract_base(T const * obj, bool enter, bool exit) noexcept(nothrow)
         :obj_{obj}
         ,exit_{exit}
     {
-        if (enter)
-            obj_->class_contract__(obj_->prepare_contract__(contract_context{false, false, true}));
+        // decided on the calling thread: options may check on other threads
+        if (enter && !suppress_scope::suppressed(type::invariant))
+            option::evaluate(obj_, &class_contract_base::check, false);
     }
 
-    ~class_contract_base() noexcept(false)
+    ~class_contract_base() noexcept(nothrow)
     {
-        if (exit_ && !std::uncaught_exception())
-            obj_->class_contract__(obj_->prepare_contract__(contract_context{false, false, true}));
+        if (exit_ && !unwinding() && !suppress_scope::suppressed(type::invariant))
+            option::evaluate(obj_, &class_contract_base::check, true);
+    }
+
+    static
+    void check(T const * obj) {
+        obj->class_contract__(obj->prepare_contract__(contract_context{false, false, true}));
     }
 
+    template <typename U>
+    static auto select_option(int) -> typename U::contract_option__;
+    template <typename U>
+    static auto select_option(...) -> immediate_option;
+
+    using option = decltype(select_option<T>(0));
+
     T const * obj_;
     bool const exit_;
 };
 
 // Performs the check for a method and class contract.  Combines the
 // functionality of <class_contract_base> and <fun_contract> classes.
-template <typename T, typename ContrFunc>
+template <typename Policy, typename T, typename ContrFunc>
 struct class_contract
-    :class_contract_base<T>
-    ,fun_contract<ContrFunc>
+    :class_contract_base<Policy, T>
+    ,fun_contract<Policy, ContrFunc>
 {
-    class_contract(T const * obj, ContrFunc f, bool enter, bool exit)
-        :class_contract_base<T>{obj, enter, exit}
-        ,fun_contract<ContrFunc>{f, enter, exit}
+    class_contract(T const * obj, ContrFunc f, bool enter, bool exit, bool sampled)
+        noexcept(fun_contract<Policy, ContrFunc>::nothrow)
+        :class_contract_base<Policy, T>{obj, enter && sampled, exit && sampled}
+        ,fun_contract<Policy, ContrFunc>{f, enter, exit, sampled}
     {}
 };
 
@@ -431,65 +1336,192 @@ struct has_class_contract {
     using type = decltype(test<T>(0));
 };
 
+// Whether the type `T` is one of the types in `List`.
+template <typename T, typename List>
+struct type_list_contains;
+
+template <typename T>
+struct type_list_contains<T, type_list<>>
+    :std::false_type
+{};
+
+template <typename T, typename U, typename ...Us>
+struct type_list_contains<T, type_list<U, Us...>>
+    :std::integral_constant<bool, std::is_same<T, U>::value
+                                  || type_list_contains<T, type_list<Us...>>::value>
+{};
+
+// Concatenation of two type lists.
+template <typename List, typename Other>
+struct type_list_concat;
+
+template <typename ...Ts, typename ...Us>
+struct type_list_concat<type_list<Ts...>, type_list<Us...>> {
+    using type = type_list<Ts..., Us...>;
+};
+
+// Last type of a non-empty type list.
+template <typename List>
+struct type_list_last;
+
+template <typename T>
+struct type_list_last<type_list<T>> {
+    using type = T;
+};
+
+template <typename T, typename U, typename ...Ts>
+struct type_list_last<type_list<T, U, Ts...>>
+    :type_list_last<type_list<U, Ts...>>
+{};
+
+// List of the base classes named by the class contract of `T`, empty if `T`
+// has no class contract.
+template <typename T, bool = has_class_contract<T>::type::value>
+struct contract_bases {
+    using type = type_list<>;
+};
+
+template <typename T>
+struct contract_bases<T, true> {
+    using type = typename class_contract_access::bases<T>::type;
+};
+
+// Paths extending `Path`, a list of classes each derived from the next, with
+// each of the classes in `Bases`.
+template <typename Path, typename Bases>
+struct extend_base_path;
+
+template <typename ...Path, typename ...Bases>
+struct extend_base_path<type_list<Path...>, type_list<Bases...>> {
+    using type = type_list<type_list<Path..., Bases>...>;
+};
+
+// Walks the base class contracts of a derived class depth first.  `Pending`
+// holds the paths to visit; `Result` collects the paths to the classes with a
+// class contract, each class once, and `Seen` those classes.
+template <typename Result, typename Seen, typename Pending>
+struct collect_base_paths {
+    using type = Result;
+};
+
+template <typename Result, typename Seen, typename Path, typename ...Paths>
+struct collect_base_paths<Result, Seen, type_list<Path, Paths...>> {
+    using base = typename type_list_last<Path>::type;
+
+    using visit = collect_base_paths<
+        typename type_list_concat<Result, type_list<Path>>::type
+        ,typename type_list_concat<type_list<base>, Seen>::type
+        ,typename type_list_concat<
+            typename extend_base_path<Path, typename contract_bases<base>::type>::type
+            ,type_list<Paths...>
+        >::type
+    >;
+    using skip = collect_base_paths<Result, Seen, type_list<Paths...>>;
+
+    using type = typename std::conditional<
+        has_class_contract<base>::type::value && !type_list_contains<base, Seen>::value
+        ,visit
+        ,skip
+    >::type::type;
+};
+
+// Paths to the base class subobjects whose class contracts are enforced by a
+// derived class contract naming the base classes in `Bases`: the transitive
+// closure over the bases named by derived class contracts, with every class
+// with a class contract once, so a base class shared by several bases (a
+// virtual base in a diamond, or a base named again next to a class derived
+// from it) is checked once per object check.  A class is reached through the
+// first path in depth first order of declaration.
+template <typename Bases>
+struct base_contract_paths;
+
+template <typename ...Bases>
+struct base_contract_paths<type_list<Bases...>> {
+    using type = typename collect_base_paths<
+        type_list<>, type_list<>, type_list<type_list<Bases>...>
+    >::type;
+};
+
 // Enforces base class contracts for a derived class.
 //
-// `Bases`   - the list of base class types with class contracts that should be
-//             enforced as part of the derived class contract.
-// `Derived` - the class derived from each of the `Bases`.
+// `Bases`   - the list of base class types named by the derived class
+//             contract; their class contracts and the base class contracts
+//             of theirs are enforced as part of the derived class contract.
 template <typename ...Bases>
 struct base_class_contract {
+    using paths = typename base_contract_paths<type_list<Bases...>>::type;
+
     template <typename Derived>
     static
-    void enforce(Derived *, contract_context const &) {}
-};
+    void enforce(Derived const * obj, contract_context const & context) {
+        enforce_paths(obj, context, paths{});
+    }
 
-template <typename Base, typename ...Bases>
-struct base_class_contract<Base, Bases...> {
-    template <typename T>
+    // Check the class contract of the base class subobject of `obj` at the
+    // end of the path `Path` only.
+    template <typename Derived, typename Path>
+    static
+    void enforce_path(Derived const * obj, contract_context const & context, Path path) {
+        subobject(obj, path)->class_contract__(context);
+    }
+
+private:
+    template <typename Derived>
+    static
+    void enforce_paths(Derived const *, contract_context const &, type_list<>) {}
+
+    template <typename Derived, typename Path, typename ...Paths>
     static
-    void do_enforce(T * obj, contract_context const & context,
-                    typename std::enable_if<has_class_contract<T>::type::value>::type * = 0)
+    void enforce_paths(Derived const * obj, contract_context const & context,
+                       type_list<Path, Paths...>)
     {
-        obj->class_contract__(context);
+        enforce_path(obj, context, Path{});
+        enforce_paths(obj, context, type_list<Paths...>{});
     }
 
+    // The conversions are made here, by a friend of every class on the path.
     template <typename T>
     static
-    void do_enforce(T *, contract_context const &,
-                    typename std::enable_if<! has_class_contract<T>::type::value>::type * = 0)
-    {}
+    T const * subobject(T const * obj, type_list<>) {
+        return obj;
+    }
 
-    template <typename Derived>
+    template <typename T, typename Base, typename ...Path>
     static
-    void enforce(Derived * obj, contract_context const & context)
-    {
-        do_enforce(static_cast<typename std::add_const<Base>::type *>(obj), context);
-        base_class_contract<Bases...>::enforce(obj, context);
+    typename type_list_last<type_list<Base, Path...>>::type const *
+    subobject(T const * obj, type_list<Base, Path...>) {
+        return subobject(static_cast<Base const *>(obj), type_list<Path...>{});
     }
 };
 
+// The class of the member function a contract is defined in, from the type of
+// `*this`.
+template <typename T>
+using this_class = typename std::remove_reference<T>::type;
+
 // Defines a bootstrapper for a contract check implementation.  When combined
 // with a `Func` functor defining the actual contract (by means of overloaded
-// `operator+`) produces a concrete implementation for the contract check.
-template <typename T, bool = has_class_contract<T>::type::value>
+// `operator+`) produces a concrete implementation for the contract check
+// governed by `Policy`.
+template <typename Policy, typename T, bool = has_class_contract<T>::type::value>
 struct contractor;
 
 // Specialization for a function contract or a method contract without a class
 // contract.
-template <typename T>
-struct contractor<T, false> {
+template <typename Policy, typename T>
+struct contractor<Policy, T, false> {
     explicit
     contractor(T const *, bool = true, bool = true) {}
 
     template <typename Func>
-    fun_contract<Func> operator+(Func f) const {
-        return fun_contract<Func>{f, true, true};
+    fun_contract<Policy, Func> operator+(Func f) const {
+        return fun_contract<Policy, Func>{f, true, true};
     }
 };
 
 // Specialization for a method contract with a class contract.
-template <typename T>
-struct contractor<T, true> {
+template <typename Policy, typename T>
+struct contractor<Policy, T, true> {
     explicit
     contractor(T const * obj, bool enter = true, bool exit = true)
         :obj_{obj}
@@ -498,8 +1530,8 @@ struct contractor<T, true> {
     {}
 
     template<typename Func>
-    class_contract<T, Func> operator+(Func f) const {
-        return class_contract<T, Func>{obj_, f, enter_, exit_};
+    class_contract<Policy, T, Func> operator+(Func f) const {
+        return class_contract<Policy, T, Func>{obj_, f, enter_, exit_, Policy::sample()};
     }
 
     T const * obj_;
@@ -510,73 +1542,185 @@ struct contractor<T, true> {
 // implementation: violation handler
 //
 
+// Name of the contract check type `t`.
+inline
+char const * type_name(type t) noexcept {
+    switch (t) {
+        case type::precondition:
+            return "precondition";
+        case type::postcondition:
+            return "postcondition";
+        case type::invariant:
+            return "invariant";
+    }
+
+    return "<unknown type>";
+}
+
+#if defined(__ct_compile_library__)
+
 // Defines a default contract violation handler.  Prints the information about
 // the contract violation to the standard error and abort the program
 // execution.
 inline
 void default_handler(violation_context const & context) {
     std::cerr << context.file << ':' << context.line
-                << ": error: contract violation of type '";
-
-    char const * type_str = "<unknown type>";
-
-    switch (context.contract_type) {
-        case type::precondition:
-            type_str = "precondition";
-            break;
-        case type::postcondition:
-            type_str = "postcondition";
-            break;
-        case type::invariant:
-            type_str = "invariant";
-            break;
+                << ": error: contract violation of type '"
+                << type_name(context.contract_type) << "'\n"
+                << "message:   " << context.message << "\n"
+                << "condition: " << context.condition << "\n";
+
+    if (context.lhs.get_kind() != captured_value::kind::none
+        || context.rhs.get_kind() != captured_value::kind::none) {
+        char value[2 * CONTRACT_CAPTURE_TEXT_SIZE];
+
+        context.lhs.format(value, sizeof(value));
+        std::cerr << "lhs:       " << value << "\n";
+        context.rhs.format(value, sizeof(value));
+        std::cerr << "rhs:       " << value << "\n";
     }
 
-    std::cerr
-        << type_str << "'\n"
-        << "message:   " << context.message << "\n"
-        << "condition: " << context.condition << std::endl;
+    if (context.iteration != violation_context::no_iteration)
+        std::cerr << "iteration: " << context.iteration << "\n";
+
+    std::cerr.flush();
 
     std::terminate();
 }
 
-// Holder for the currently installed contract failure handler.
+// Holder for the currently installed contract failure handler.  The handler
+// is shared and replaced atomically, so it can be set and called from any
+// thread.
 // Templated with a dummy type to be able to keep it in the header file.
 template <typename = void>
 struct handler_holder {
+    using pointer = std::shared_ptr<violation_handler const>;
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+    static
+    std::atomic<pointer> current_handler;
+
+    static
+    pointer load() noexcept {
+        return current_handler.load();
+    }
+
+    static
+    pointer exchange(pointer handler) noexcept {
+        return current_handler.exchange(std::move(handler));
+    }
+#else
     static
-    violation_handler current_handler;
+    pointer current_handler;
+
+    static
+    pointer load() noexcept {
+        return std::atomic_load(&current_handler);
+    }
+
+    static
+    pointer exchange(pointer handler) noexcept {
+        return std::atomic_exchange(&current_handler, std::move(handler));
+    }
+#endif
 };
 
+#if defined(__cpp_lib_atomic_shared_ptr)
 template <typename T>
-violation_handler handler_holder<T>::current_handler{default_handler};
+std::atomic<typename handler_holder<T>::pointer> handler_holder<T>::current_handler{
+    std::make_shared<violation_handler const>(default_handler)};
+#else
+template <typename T>
+typename handler_holder<T>::pointer handler_holder<T>::current_handler{
+    std::make_shared<violation_handler const>(default_handler)};
+#endif
+
+#endif // __ct_compile_library__
 
 } // namespace detail
 
 /***************************************************************************/
 
-inline
+// Contract check bootstrapper governed by `Policy`.  `T` is the class of the
+// member function the contract is defined in, or `void *` for free functions.
+template <typename Policy, typename T = void *>
+using basic_contractor = detail::contractor<Policy, T>;
+
+#if defined(__ct_compile_library__)
+
+__ct_inline__
 void handle_violation(violation_context const & context) {
-    detail::handler_holder<>::current_handler(context);
+    (*detail::handler_holder<>::load())(context);
 
     // if the handler returns, abort anyway to satisfy the [[noreturn]] contract
     std::terminate();
 }
 
-inline
+__ct_inline__
 violation_handler set_handler(violation_handler new_handler) {
-    violation_handler old_handler = detail::handler_holder<>::current_handler;
-    detail::handler_holder<>::current_handler = new_handler;
-    return old_handler;
+    return *detail::handler_holder<>::exchange(
+        std::make_shared<violation_handler const>(std::move(new_handler)));
 }
 
-inline
+__ct_inline__
 violation_handler get_handler() {
-    return detail::handler_holder<>::current_handler;
+    return *detail::handler_holder<>::load();
+}
+
+#endif // __ct_compile_library__
+
+// implementation: suppression scopes
+//
+
+inline
+suppress_scope::suppress_scope() noexcept
+    :previous_{detail::suppress_holder<>::mask()}
+{
+    detail::suppress_holder<>::mask() = ~0u;
+}
+
+inline
+suppress_scope::suppress_scope(type t) noexcept
+    :previous_{detail::suppress_holder<>::mask()}
+{
+    detail::suppress_holder<>::mask() = previous_ | detail::suppress_bit(t);
+}
+
+inline
+suppress_scope::~suppress_scope() {
+    detail::suppress_holder<>::mask() = previous_;
+}
+
+inline
+bool suppress_scope::suppressed(type t) noexcept {
+    return (detail::suppress_holder<>::mask() & detail::suppress_bit(t)) != 0;
 }
 
 } // namespace contract
 
+// Contract policy used outside of namespaces and classes that select their
+// own with `CONTRACT_POLICY(...)`.  Instrumented builds (`CONTRACT_INSTRUMENTED`)
+// count every check in the shared-memory metrics segment, see
+// <contract/metrics.hpp>.
+#if defined(CONTRACT_INSTRUMENTED)
+__ct_export__ namespace contract { struct metrics_policy; }
+__ct_export__ CONTRACT_POLICY(::contract::metrics_policy);
+#else
+__ct_export__ CONTRACT_POLICY(::contract::default_policy);
+#endif
+
+#if defined(CONTRACT_FAULT_INJECTION)
+#	include <contract/fault_injection.hpp>
+#endif
+
+#if defined(CONTRACT_INSTRUMENTED)
+#	include <contract/metrics.hpp>
+#endif
+
+#if defined(CONTRACT_SITE_CONFIG)
+#	include CONTRACT_SITE_CONFIG
+#endif
+
 /***************************************************************************/
 
 #endif // __contract_hpp__included
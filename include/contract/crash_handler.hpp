@@ -0,0 +1,245 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef __contract_crash_handler_hpp__included
+#define __contract_crash_handler_hpp__included
+
+/***************************************************************************/
+
+#include <contract/contract.hpp>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+
+#if defined(_WIN32)
+#	include <io.h>
+#	include <process.h>
+#else
+#	include <unistd.h>
+#endif
+
+/***************************************************************************/
+
+namespace contract {
+
+// interface: crash handler
+//
+
+// Binary record of a contract violation written by <crash_handler>.
+//
+// Every record has the same size and layout, so a file of records can be read
+// back with a plain `read` of `sizeof(crash_record)` bytes per record on the
+// same platform.  Strings are NUL-terminated and truncated to their fields.
+struct crash_record {
+    enum: std::uint32_t {
+         magic_value   = 0x48435443  // "CTCH"
+        ,version_value = 1
+    };
+
+    std::uint32_t magic;          // <magic_value>
+    std::uint32_t version;        // <version_value>
+    std::uint64_t time;           // seconds since the epoch
+    std::uint64_t pid;            // process id
+    std::uint64_t line;           // line of the failed contract check
+    std::uint8_t  contract_type;  // <contract::type> of the failed check
+    char file[119];
+    char message[256];
+    char condition[256];
+    char lhs[64];                 // formatted <violation_context::lhs>
+    char rhs[64];                 // formatted <violation_context::rhs>
+};
+
+// Set the file descriptor of the crash reports.
+//
+// Set the file descriptor <crash_handler> writes the text report of a
+// contract violation to; the standard error (2) by default.  A negative value
+// disables the text report.  The descriptor is not owned by the library.
+//
+// @fd       file descriptor open for writing.
+// @returns  the previous file descriptor.
+__ct_decl__ int set_crash_fd(int fd) noexcept;
+
+// Set the file descriptor of the binary crash records.
+//
+// Set the file descriptor <crash_handler> writes a <crash_record> to, in
+// addition to the text report.  It is disabled (-1) by default.  Open the file
+// up front, in append mode: nothing can be opened safely once the process is
+// failing.  The descriptor is not owned by the library.
+//
+// @fd       file descriptor open for writing, or -1 to disable the records.
+// @returns  the previous file descriptor.
+__ct_decl__ int set_crash_record_fd(int fd) noexcept;
+
+// Report a contract violation without allocating.
+//
+// Format the report into a buffer on the stack and write it to the crash
+// report descriptor with `write`, then write a <crash_record> to the record
+// descriptor if one is set.  Only async-signal-safe functions are used, so
+// this works under memory pressure, after heap corruption and from signal
+// handlers.
+//
+// @context  the context data for the contract violation.
+__ct_decl__ void report_crash(violation_context const & context) noexcept;
+
+// Crash-grade contract violation handler.
+//
+// Report the violation with <report_crash> and call `std::abort`.  Install it
+// with `contract::set_handler(contract::crash_handler)`, or use
+// <crash_policy> to call it without going through the installed handler.
+//
+// @context  the context data for the contract violation.
+[[noreturn]] __ct_decl__
+void crash_handler(violation_context const & context) noexcept;
+
+// Contract policy that checks everything and handles violations with
+// <crash_handler>.
+struct crash_policy: default_policy {
+    [[noreturn]]
+    static void handle(violation_context const & context) noexcept {
+        crash_handler(context);
+    }
+};
+
+/***************************************************************************/
+
+#if defined(__ct_compile_library__)
+
+namespace detail {
+
+// implementation: crash handler
+//
+
+// Holder for the crash handler file descriptors.  The atomics are constant
+// initialized, so reading them never takes a lock or runs a guard.
+// Templated with a dummy type to be able to keep it in the header file.
+template <typename = void>
+struct crash_holder {
+    static std::atomic<int> report_fd;
+    static std::atomic<int> record_fd;
+};
+
+template <typename T>
+std::atomic<int> crash_holder<T>::report_fd{2};
+
+template <typename T>
+std::atomic<int> crash_holder<T>::record_fd{-1};
+
+// Write all of `size` bytes at `data`, retrying on interruption.
+inline
+void crash_write(int fd, void const * data, std::size_t size) noexcept {
+    char const * p = static_cast<char const *>(data);
+
+    while (size != 0) {
+#if defined(_WIN32)
+        int const n = ::_write(fd, p, static_cast<unsigned>(size));
+#else
+        ::ssize_t const n = ::write(fd, p, size);
+#endif
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return;
+
+        p += n;
+        size -= static_cast<std::size_t>(n);
+    }
+}
+
+template <std::size_t N>
+void crash_copy(char (&dst)[N], char const * src) noexcept {
+    format_buffer{dst, N}.put(src);
+}
+
+inline
+bool has_operands(violation_context const & context) noexcept {
+    return context.lhs.get_kind() != captured_value::kind::none
+        || context.rhs.get_kind() != captured_value::kind::none;
+}
+
+} // namespace detail
+
+/***************************************************************************/
+
+__ct_inline__
+int set_crash_fd(int fd) noexcept {
+    return detail::crash_holder<>::report_fd.exchange(fd);
+}
+
+__ct_inline__
+int set_crash_record_fd(int fd) noexcept {
+    return detail::crash_holder<>::record_fd.exchange(fd);
+}
+
+__ct_inline__
+void report_crash(violation_context const & context) noexcept {
+    int const report_fd = detail::crash_holder<>::report_fd.load();
+    int const record_fd = detail::crash_holder<>::record_fd.load();
+
+    if (report_fd >= 0) {
+        char buf[1024];
+        detail::format_buffer out{buf, sizeof(buf)};
+
+        out.put(context.file).put(':').put_unsigned(context.line)
+           .put(": error: contract violation of type '")
+           .put(detail::type_name(context.contract_type)).put("'\n")
+           .put("message:   ").put(context.message).put('\n')
+           .put("condition: ").put(context.condition).put('\n');
+
+        if (detail::has_operands(context)) {
+            char value[2 * CONTRACT_CAPTURE_TEXT_SIZE];
+
+            context.lhs.format(value, sizeof(value));
+            out.put("lhs:       ").put(value).put('\n');
+            context.rhs.format(value, sizeof(value));
+            out.put("rhs:       ").put(value).put('\n');
+        }
+
+        detail::crash_write(report_fd, out.c_str(), out.size());
+    }
+
+    if (record_fd >= 0) {
+        crash_record record = {};
+
+        record.magic = crash_record::magic_value;
+        record.version = crash_record::version_value;
+        record.time = static_cast<std::uint64_t>(std::time(nullptr));
+#if defined(_WIN32)
+        record.pid = static_cast<std::uint64_t>(::_getpid());
+#else
+        record.pid = static_cast<std::uint64_t>(::getpid());
+#endif
+        record.line = context.line;
+        record.contract_type = static_cast<std::uint8_t>(context.contract_type);
+        detail::crash_copy(record.file, context.file);
+        detail::crash_copy(record.message, context.message);
+        detail::crash_copy(record.condition, context.condition);
+        if (detail::has_operands(context)) {
+            context.lhs.format(record.lhs, sizeof(record.lhs));
+            context.rhs.format(record.rhs, sizeof(record.rhs));
+        }
+
+        detail::crash_write(record_fd, &record, sizeof(record));
+    }
+}
+
+__ct_inline__
+void crash_handler(violation_context const & context) noexcept {
+    report_crash(context);
+    std::abort();
+}
+
+#endif // __ct_compile_library__
+
+} // namespace contract
+
+/***************************************************************************/
+
+#endif // __contract_crash_handler_hpp__included
@@ -0,0 +1,150 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef __contract_deferred_hpp__included
+#define __contract_deferred_hpp__included
+
+/***************************************************************************/
+
+#include <contract/contract.hpp>
+#include <contract/detail/thread_pool.hpp>
+
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+/***************************************************************************/
+
+// Number of verifier threads checking deferred class invariants.
+#if !defined(CONTRACT_DEFERRED_THREADS)
+#	define CONTRACT_DEFERRED_THREADS 1
+#endif
+
+/***************************************************************************/
+
+namespace contract {
+
+// interface: deferred invariant checks
+//
+
+// Wait for deferred invariant checks.
+//
+// Wait until the verifier threads have checked all the class invariants
+// deferred so far.  Violations found by the verifier threads are reported to
+// the contract violation handler on the verifier thread.  If the handler
+// exits via an exception, the first such exception is rethrown here.
+void wait_deferred_checks();
+
+/***************************************************************************/
+
+namespace detail {
+
+// implementation: code behind macros
+//
+
+// Holder for the verifier threads and the first exception thrown by a
+// deferred check.  Templated with a dummy type to be able to keep it in the
+// header file.
+template <typename = void>
+struct deferred_holder {
+    static
+    thread_pool & verifier() {
+        static thread_pool pool{CONTRACT_DEFERRED_THREADS};
+        return pool;
+    }
+
+    static
+    std::mutex & error_mutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static
+    std::exception_ptr & error() {
+        static std::exception_ptr first;
+        return first;
+    }
+
+    // Depth of the scopes on the current thread in which deferred checks are
+    // not enqueued: while a snapshot is copied and while a snapshot is checked
+    // or destroyed.  Their own contracts would enqueue new snapshots forever.
+    static
+    int & suspended() {
+        static thread_local int depth = 0;
+        return depth;
+    }
+};
+
+struct deferred_suspend {
+    deferred_suspend() { ++deferred_holder<>::suspended(); }
+    ~deferred_suspend() { --deferred_holder<>::suspended(); }
+
+    deferred_suspend(deferred_suspend const &) = delete;
+    deferred_suspend & operator=(deferred_suspend const &) = delete;
+};
+
+// Class contract evaluation option that checks the class invariant on a
+// verifier thread.  On method and constructor exit the object is copied into
+// an immutable snapshot, which is checked off the calling thread.  Entry
+// checks are not deferred, since the state on entry was already checked on the
+// exit of the previous call.
+struct deferred_option {
+    template <typename T>
+    static
+    void evaluate(T const * obj, void (*check)(T const *), bool exit) {
+        static_assert(std::is_copy_constructible<T>::value,
+                      "deferred class contract requires a copyable class");
+
+        if (!exit || deferred_holder<>::suspended() != 0)
+            return;
+
+        std::shared_ptr<T const> snapshot;
+        {
+            deferred_suspend suspend;
+            snapshot = std::make_shared<T const>(*obj);
+        }
+
+        deferred_holder<>::verifier().submit([snapshot, check]() mutable {
+            deferred_suspend suspend;
+
+            __ct_try__ {
+                check(snapshot.get());
+            } __ct_catch_all__ {
+                std::lock_guard<std::mutex> lock{deferred_holder<>::error_mutex()};
+                if (!deferred_holder<>::error())
+                    deferred_holder<>::error() = std::current_exception();
+            }
+
+            snapshot.reset();
+        });
+    }
+};
+
+} // namespace detail
+
+/***************************************************************************/
+
+inline
+void wait_deferred_checks() {
+    detail::deferred_holder<>::verifier().wait_idle();
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock{detail::deferred_holder<>::error_mutex()};
+        std::swap(error, detail::deferred_holder<>::error());
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+} // namespace contract
+
+/***************************************************************************/
+
+#endif // __contract_deferred_hpp__included
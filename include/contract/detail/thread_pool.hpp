@@ -0,0 +1,145 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef __contract_detail_thread_pool_hpp__included
+#define __contract_detail_thread_pool_hpp__included
+
+/***************************************************************************/
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/***************************************************************************/
+
+namespace contract {
+namespace detail {
+
+// Pool of worker threads used to check contracts off the calling thread.
+// Tasks are run in submission order; they must not throw.
+class thread_pool {
+public:
+    using task = std::function<void ()>;
+
+    explicit
+    thread_pool(std::size_t threads)
+        :busy_{0}
+        ,stop_{false}
+    {
+        if (threads == 0)
+            threads = 1;
+
+        for (std::size_t i = 0; i != threads; ++i)
+            threads_.emplace_back([this] { work(); });
+    }
+
+    // Runs the pending tasks and joins the workers.
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            stop_ = true;
+        }
+
+        ready_.notify_all();
+        for (std::thread & t: threads_)
+            t.join();
+    }
+
+    thread_pool(thread_pool const &) = delete;
+    thread_pool & operator=(thread_pool const &) = delete;
+
+    void submit(task t) {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            tasks_.push_back(std::move(t));
+        }
+
+        ready_.notify_one();
+    }
+
+    // Run one pending task on the calling thread.
+    //
+    // @returns  `false` if there was no pending task.
+    bool run_pending() {
+        task t;
+
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (tasks_.empty())
+                return false;
+
+            t = std::move(tasks_.front());
+            tasks_.pop_front();
+            ++busy_;
+        }
+
+        run(t);
+        return true;
+    }
+
+    // Wait until all submitted tasks have completed.
+    void wait_idle() {
+        std::unique_lock<std::mutex> lock{mutex_};
+        idle_.wait(lock, [this] { return tasks_.empty() && busy_ == 0; });
+    }
+
+    std::size_t size() const { return threads_.size(); }
+
+private:
+    void work() {
+        for (;;) {
+            task t;
+
+            {
+                std::unique_lock<std::mutex> lock{mutex_};
+                ready_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+                if (tasks_.empty())
+                    return;
+
+                t = std::move(tasks_.front());
+                tasks_.pop_front();
+                ++busy_;
+            }
+
+            run(t);
+        }
+    }
+
+    void run(task & t) {
+        t();
+        t = nullptr;
+
+        bool idle;
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            idle = --busy_ == 0 && tasks_.empty();
+        }
+
+        if (idle)
+            idle_.notify_all();
+    }
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::condition_variable idle_;
+    std::deque<task> tasks_;
+    std::size_t busy_;
+    bool stop_;
+    std::vector<std::thread> threads_;
+};
+
+} // namespace detail
+} // namespace contract
+
+/***************************************************************************/
+
+#endif // __contract_detail_thread_pool_hpp__included
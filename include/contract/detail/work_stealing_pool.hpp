@@ -0,0 +1,197 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef __contract_detail_work_stealing_pool_hpp__included
+#define __contract_detail_work_stealing_pool_hpp__included
+
+/***************************************************************************/
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/***************************************************************************/
+
+namespace contract {
+namespace detail {
+
+// Pool of worker threads, each with its own queue of tasks.  A worker runs
+// the tasks it submitted itself last in, first out, and steals the oldest
+// tasks of the other queues when its own is empty, so the tasks spawned by a
+// long task stay on its worker while idle workers take over the rest.  Tasks
+// submitted from other threads are spread over the queues, and those threads
+// only steal.  Tasks must not throw.
+class work_stealing_pool {
+public:
+    using task = std::function<void ()>;
+
+    explicit
+    work_stealing_pool(std::size_t threads)
+        :queued_{0}
+        ,next_{0}
+        ,stop_{false}
+    {
+        if (threads == 0)
+            threads = 1;
+
+        for (std::size_t i = 0; i != threads; ++i)
+            queues_.emplace_back(new queue);
+        for (std::size_t i = 0; i != threads; ++i)
+            threads_.emplace_back([this, i] { work(i); });
+    }
+
+    // Runs the pending tasks and joins the workers.
+    ~work_stealing_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            stop_ = true;
+        }
+
+        ready_.notify_all();
+        for (std::thread & t: threads_)
+            t.join();
+    }
+
+    work_stealing_pool(work_stealing_pool const &) = delete;
+    work_stealing_pool & operator=(work_stealing_pool const &) = delete;
+
+    void submit(task t) {
+        worker const & self = current();
+        std::size_t const index = self.pool == this
+                                ? self.index
+                                : next_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+
+        // counted first, so a worker that finds the task never sees the count
+        // drop below zero
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            ++queued_;
+        }
+
+        {
+            queue & q = *queues_[index];
+            std::lock_guard<std::mutex> lock{q.mutex};
+            q.tasks.push_back(std::move(t));
+        }
+
+        ready_.notify_one();
+    }
+
+    // Run one pending task on the calling thread: one of its own queue on a
+    // worker, else one stolen from any queue.
+    //
+    // @returns  `false` if there was no pending task.
+    bool run_pending() {
+        worker const & self = current();
+
+        task t;
+        if (self.pool == this ? !take(self.index, t) : !steal(0, t))
+            return false;
+
+        t();
+        return true;
+    }
+
+    std::size_t size() const { return threads_.size(); }
+
+private:
+    struct queue {
+        std::mutex mutex;
+        std::deque<task> tasks;
+    };
+
+    // The pool and queue of the calling thread, if it is a worker.
+    struct worker {
+        work_stealing_pool const * pool;
+        std::size_t index;
+    };
+
+    static
+    worker & current() {
+        static thread_local worker self{nullptr, 0};
+        return self;
+    }
+
+    // Take the newest task of the queue of worker `index`, else steal one.
+    bool take(std::size_t index, task & t) {
+        {
+            queue & own = *queues_[index];
+            std::lock_guard<std::mutex> lock{own.mutex};
+            if (!own.tasks.empty()) {
+                t = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return taken();
+            }
+        }
+
+        return steal(index + 1, t);
+    }
+
+    // Take the oldest task of the first nonempty queue from queue `first` on,
+    // wrapping around.
+    bool steal(std::size_t first, task & t) {
+        for (std::size_t i = 0; i != queues_.size(); ++i) {
+            queue & other = *queues_[(first + i) % queues_.size()];
+            std::lock_guard<std::mutex> lock{other.mutex};
+            if (!other.tasks.empty()) {
+                t = std::move(other.tasks.front());
+                other.tasks.pop_front();
+                return taken();
+            }
+        }
+
+        return false;
+    }
+
+    bool taken() {
+        std::lock_guard<std::mutex> lock{mutex_};
+        --queued_;
+        return true;
+    }
+
+    void work(std::size_t index) {
+        current() = worker{this, index};
+
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock{mutex_};
+                ready_.wait(lock, [this] { return stop_ || queued_ != 0; });
+                if (stop_ && queued_ == 0)
+                    return;
+            }
+
+            // the task may still be on its way into its queue
+            task t;
+            if (take(index, t))
+                t();
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    std::vector<std::unique_ptr<queue>> queues_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::size_t queued_;
+    std::atomic<std::size_t> next_;
+    bool stop_;
+    std::vector<std::thread> threads_;
+};
+
+} // namespace detail
+} // namespace contract
+
+/***************************************************************************/
+
+#endif // __contract_detail_work_stealing_pool_hpp__included
@@ -0,0 +1,282 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef __contract_fault_injection_hpp__included
+#define __contract_fault_injection_hpp__included
+
+/***************************************************************************/
+
+#include <contract/contract.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+/***************************************************************************/
+
+// Maximum number of fault injection rules.
+#if !defined(CONTRACT_FAULT_RULES)
+#	define CONTRACT_FAULT_RULES 16
+#endif
+
+/***************************************************************************/
+
+namespace contract {
+
+// interface: fault injection
+//
+
+// Rule selecting contract checks that report a violation even though their
+// condition holds.
+//
+// Fault injection is a test-support mode enabled by defining the macro
+// `CONTRACT_FAULT_INJECTION` before including <contract/contract.hpp>.  In
+// this mode every evaluated contract check is matched against the injected
+// rules, and a check selected by a rule is reported to its policy's `handle`
+// as violated.  The condition is still evaluated first, so the program sees
+// the same side effects.  Without the macro the rules are never consulted and
+// cost nothing.
+class fault_rule {
+public:
+    // Select all checks.
+    fault_rule() noexcept
+        :file_{nullptr}
+        ,line_{0}
+        ,types_{~0u}
+        ,threshold_{~std::uint64_t{0}}
+    {}
+
+    static
+    fault_rule everywhere() noexcept {
+        return fault_rule{};
+    }
+
+    // Select the checks in files whose path ends with `file`, on `line` (any
+    // line if 0).  The string must outlive the rule.
+    static
+    fault_rule at(char const * file, std::size_t line = 0) noexcept {
+        fault_rule rule;
+        rule.file_ = file;
+        rule.line_ = line;
+        return rule;
+    }
+
+    // Select the checks of type `t`.
+    static
+    fault_rule of_type(type t) noexcept {
+        fault_rule rule;
+        rule.types_ = 1u << static_cast<unsigned>(t);
+        return rule;
+    }
+
+    // Also require the check to be of type `t`.
+    fault_rule & only(type t) noexcept {
+        types_ &= 1u << static_cast<unsigned>(t);
+        return *this;
+    }
+
+    // Select each matching evaluation with the probability `p` only.
+    fault_rule & probability(double p) noexcept {
+        threshold_ = p >= 1 ? ~std::uint64_t{0}
+                   : p <= 0 ? 0
+                   : static_cast<std::uint64_t>(p * 18446744073709551616.0);
+        return *this;
+    }
+
+    // Whether the rule selects the check `site`, not counting the probability.
+    bool matches(check_site const & site) const noexcept {
+        if ((types_ & (1u << static_cast<unsigned>(site.contract_type))) == 0)
+            return false;
+        if (line_ != 0 && site.line != line_)
+            return false;
+        if (file_) {
+            std::size_t const size = std::strlen(file_);
+            std::size_t const path = std::strlen(site.file);
+            if (size > path || std::strcmp(site.file + path - size, file_) != 0)
+                return false;
+        }
+        return true;
+    }
+
+    std::uint64_t threshold() const noexcept { return threshold_; }
+
+private:
+    char const * file_;
+    std::size_t line_;
+    unsigned types_;
+    std::uint64_t threshold_;
+};
+
+// Add a fault injection rule.
+//
+// Rules are meant to be set up before the checks they select run
+// concurrently; <clear_faults> must not race with contract checks.
+//
+// @returns  `false` if there are already `CONTRACT_FAULT_RULES` rules.
+__ct_decl__ bool inject_faults(fault_rule const & rule) noexcept;
+
+// Add fault injection rules described by `spec`.
+//
+// The spec is a comma-separated list of rules of the form `what[@p]`, where
+// `what` is `*`, a contract type (`precondition`, `postcondition`,
+// `invariant`) or `file[:line]`, and `p` is the probability, for example
+// "account.cpp:42,invariant@0.01".  This is handy to set the rules from an
+// environment variable.  The spec must outlive the rules.
+//
+// @returns  `false` if the spec is malformed or there are too many rules; the
+//           rules before the error are kept.
+__ct_decl__ bool inject_faults(char * spec) noexcept;
+
+// Remove all fault injection rules.
+__ct_decl__ void clear_faults() noexcept;
+
+// Number of violations injected so far.
+__ct_decl__ std::uint64_t injected_faults() noexcept;
+
+/***************************************************************************/
+
+namespace detail {
+
+// implementation: fault injection
+//
+
+// Whether a violation of the check `site` is injected on this evaluation.
+__ct_decl__ bool inject_fault(check_site const & site) noexcept;
+
+#if defined(__ct_compile_library__)
+
+// Holder for the fault injection rules.  Rules are published by incrementing
+// the count after they are written.
+// Templated with a dummy type to be able to keep it in the header file.
+template <typename = void>
+struct fault_holder {
+    static fault_rule rules[CONTRACT_FAULT_RULES];
+    static std::atomic<std::size_t> count;
+    static std::atomic<std::uint64_t> injected;
+
+    // xorshift64* per thread
+    static
+    std::uint64_t random() noexcept {
+        static thread_local std::uint64_t state =
+            0x9e3779b97f4a7c15ull ^ reinterpret_cast<std::uintptr_t>(&state);
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545f4914f6cdd1dull;
+    }
+};
+
+template <typename T>
+fault_rule fault_holder<T>::rules[CONTRACT_FAULT_RULES] = {};
+
+template <typename T>
+std::atomic<std::size_t> fault_holder<T>::count{0};
+
+template <typename T>
+std::atomic<std::uint64_t> fault_holder<T>::injected{0};
+
+__ct_inline__
+bool inject_fault(check_site const & site) noexcept {
+    std::size_t const count = fault_holder<>::count.load(std::memory_order_acquire);
+
+    for (std::size_t i = 0; i != count; ++i) {
+        fault_rule const & rule = fault_holder<>::rules[i];
+
+        if (rule.threshold() != 0 && rule.matches(site)
+            && (rule.threshold() == ~std::uint64_t{0}
+                || fault_holder<>::random() < rule.threshold())) {
+            fault_holder<>::injected.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#endif // __ct_compile_library__
+
+} // namespace detail
+
+/***************************************************************************/
+
+#if defined(__ct_compile_library__)
+
+__ct_inline__
+bool inject_faults(fault_rule const & rule) noexcept {
+    std::size_t const count = detail::fault_holder<>::count.load(std::memory_order_relaxed);
+    if (count == CONTRACT_FAULT_RULES)
+        return false;
+
+    detail::fault_holder<>::rules[count] = rule;
+    detail::fault_holder<>::count.store(count + 1, std::memory_order_release);
+    return true;
+}
+
+__ct_inline__
+bool inject_faults(char * spec) noexcept {
+    for (char * next = spec; next && *next;) {
+        char * item = next;
+        next = std::strchr(item, ',');
+        if (next)
+            *next++ = '\0';
+
+        double p = 1;
+        if (char * at = std::strchr(item, '@')) {
+            *at = '\0';
+            char * end = nullptr;
+            p = std::strtod(at + 1, &end);
+            if (end == at + 1 || *end != '\0')
+                return false;
+        }
+
+        fault_rule rule = fault_rule::everywhere();
+        if (std::strcmp(item, "precondition") == 0)
+            rule = fault_rule::of_type(type::precondition);
+        else if (std::strcmp(item, "postcondition") == 0)
+            rule = fault_rule::of_type(type::postcondition);
+        else if (std::strcmp(item, "invariant") == 0)
+            rule = fault_rule::of_type(type::invariant);
+        else if (std::strcmp(item, "*") != 0) {
+            std::size_t line = 0;
+            if (char * colon = std::strrchr(item, ':')) {
+                char * end = nullptr;
+                line = static_cast<std::size_t>(std::strtoul(colon + 1, &end, 10));
+                if (end == colon + 1 || *end != '\0')
+                    return false;
+                *colon = '\0';
+            }
+            if (*item == '\0')
+                return false;
+            rule = fault_rule::at(item, line);
+        }
+
+        if (!inject_faults(rule.probability(p)))
+            return false;
+    }
+
+    return true;
+}
+
+__ct_inline__
+void clear_faults() noexcept {
+    detail::fault_holder<>::count.store(0, std::memory_order_release);
+}
+
+__ct_inline__
+std::uint64_t injected_faults() noexcept {
+    return detail::fault_holder<>::injected.load(std::memory_order_relaxed);
+}
+
+#endif // __ct_compile_library__
+
+} // namespace contract
+
+/***************************************************************************/
+
+#endif // __contract_fault_injection_hpp__included
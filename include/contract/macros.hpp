@@ -0,0 +1,784 @@
+
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef __contract_macros_hpp__included
+#define __contract_macros_hpp__included
+
+// Preprocessor layer of the contract library: configuration macros, contract
+// blocks and contract checks.  Included by <contract/contract.hpp>; a
+// translation unit that gets the declarations with `import contract;`
+// includes it on its own, see src/contract.cppm.
+
+/***************************************************************************/
+
+// Separate compilation: with `CONTRACT_SEPARATE_COMPILATION` defined the
+// violation handler, the shared-memory metrics, the binary violation log,
+// fault injection and the crash handler are only declared by the headers and
+// defined once in the compiled library (src/contract.cpp, the `contract::static`
+// and `contract::shared` CMake targets), which then holds their state for the
+// whole process.  Only the code of the checks themselves stays inline.
+// Define `CONTRACT_DYN_LINK` as well when linking to the shared library.
+#if defined(CONTRACT_SEPARATE_COMPILATION)
+#	define __ct_inline__
+#	if defined(_WIN32) && defined(CONTRACT_DYN_LINK)
+#		if defined(CONTRACT_SOURCE)
+#			define __ct_decl__ __declspec(dllexport)
+#		else
+#			define __ct_decl__ __declspec(dllimport)
+#		endif
+#	elif defined(__GNUC__)
+#		define __ct_decl__ __attribute__((__visibility__("default")))
+#	else
+#		define __ct_decl__
+#	endif
+#	if defined(CONTRACT_SOURCE)
+#		define __ct_compile_library__
+#	endif
+#else
+#	define __ct_inline__ inline
+#	define __ct_decl__
+#	define __ct_compile_library__
+#endif
+
+// Module interface: <contract/contract.hpp> included in the purview of the
+// `contract` module (src/contract.cppm) exports its declarations.
+#if defined(CONTRACT_MODULE_INTERFACE)
+#	define __ct_export__ export
+#else
+#	define __ct_export__
+#endif
+
+#ifdef __GNUC__
+#  define __CT_UNUSED(x) x __attribute__((__unused__))
+#elif defined(_MSC_VER)
+#  define __CT_UNUSED(x) __pragma(warning(suppress:4100)) x
+#else
+#  define __CT_UNUSED(x) x
+#endif
+
+#define __ct_stringify_imp__(x) #x
+#define __ct_stringify__(x) stringify_imp__(x)
+
+// macros for variadic argument dispatch
+#define __ct_arg_pos__(_1,_2,_3,_4,_5, N, ...) N
+#define __ct_arg_count__(...) __ct_arg_pos__(__VA_ARGS__, 5, 4, 3, 2, 1)
+
+// dispatch of checks with a formatted message: `N` for a message format with
+// up to 14 arguments
+#define __ct_arg_pos16__(_1,_2,_3,_4,_5,_6,_7,_8,_9,_10,_11,_12,_13,_14,_15,_16, N, ...) N
+#define __ct_msg_arity__(...) \
+    __ct_arg_pos16__(__VA_ARGS__, N, N, N, N, N, N, N, N, N, N, N, N, N, N, 2, 1)
+#define __ct_cmp_arity__(...) \
+    __ct_arg_pos16__(__VA_ARGS__, N, N, N, N, N, N, N, N, N, N, N, N, N, 3, 2, 1)
+
+#define __ct_concat2__(macro, argc) macro ## argc
+#define __ct_concat__(macro, argc) __ct_concat2__(macro, argc)
+
+// Number of values a function contract block can snapshot on entry to compare
+// them on exit, see `INVARIANT_UNCHANGED` in <contract/containers.hpp>.
+#if !defined(CONTRACT_SNAPSHOT_SLOTS)
+#	define CONTRACT_SNAPSHOT_SLOTS 4
+#endif
+
+// Number of `LOOP_INVARIANT(...)` checks a deferred loop contract block can
+// hold, see `CONTRACT(loop, deferred)`.
+#if !defined(CONTRACT_LOOP_CHECKS)
+#	define CONTRACT_LOOP_CHECKS 8
+#endif
+
+// Size of the inline buffer holding a string operand captured by a failed
+// comparison check, see <contract::captured_value>.
+#if !defined(CONTRACT_CAPTURE_TEXT_SIZE)
+#	define CONTRACT_CAPTURE_TEXT_SIZE 24
+#endif
+
+// Size of the per-thread buffer a formatted contract message is written to,
+// see `PRECONDITION(cond, fmt, args...)`.
+#if !defined(CONTRACT_MESSAGE_SIZE)
+#	define CONTRACT_MESSAGE_SIZE 256
+#endif
+
+// Semantic of failed contract checks:
+//   `enforce`       - the violation is reported to the `handle` member of the
+//                     policy in scope (see <contract::default_policy>),
+//   `quick_enforce` - a trap instruction is executed on the spot: no
+//                     <violation_context> is built, no handler is called, and
+//                     no conditions, file names or messages are compiled into
+//                     the binary.  Checks are not counted by the policy, and
+//                     fault injection and formatted messages are left out.
+//                     Made for always-on checks in latency-critical code that
+//                     would otherwise be built with contracts disabled.
+// Define it on the command line, for example
+// `-DCONTRACT_SEMANTIC=quick_enforce`.
+#if !defined(CONTRACT_SEMANTIC)
+#	define CONTRACT_SEMANTIC enforce
+#endif
+
+#define __ct_semantic_enforce 1
+#define __ct_semantic_quick_enforce 2
+
+#if __ct_concat__(__ct_semantic_, CONTRACT_SEMANTIC) == 2
+#	define __ct_quick_enforce__
+#elif __ct_concat__(__ct_semantic_, CONTRACT_SEMANTIC) != 1
+#	error "CONTRACT_SEMANTIC must be enforce or quick_enforce"
+#endif
+
+// Header with the levels of the contract checks, generated by the
+// `contract-pgo` tool from the evaluation counts of earlier runs (see
+// <contract::site_config>).  Define it on the command line, for example
+// `-DCONTRACT_SITE_CONFIG='"contract_sites.hpp"'`; without it every check is
+// evaluated whenever its contract block is.  Checks of the `audit` level are
+// only compiled in if `CONTRACT_AUDIT` is defined as well.
+
+// Abnormal termination of a `quick_enforce` check.
+#if defined(__GNUC__) || defined(__clang__)
+#	define __ct_trap__() __builtin_trap()
+#elif defined(_MSC_VER)
+#	define __ct_trap__() __debugbreak()
+#else
+#	define __ct_trap__() ::std::abort()
+#endif
+
+// Build without exception support: contract blocks never throw, violations are
+// enforced by the handler alone, and the library uses no try blocks.  Defined
+// automatically when the compiler has exceptions disabled (-fno-exceptions).
+#if !defined(CONTRACT_NO_EXCEPTIONS) \
+    && !defined(__cpp_exceptions) && !defined(__EXCEPTIONS) && !defined(_CPPUNWIND)
+#	define CONTRACT_NO_EXCEPTIONS
+#endif
+
+#if defined(CONTRACT_NO_EXCEPTIONS)
+#	define __ct_try__ if (true)
+#	define __ct_catch_all__ if (false)
+#else
+#	define __ct_try__ try
+#	define __ct_catch_all__ catch (...)
+#endif
+
+/***************************************************************************/
+
+#define CONTRACT_LIB_VERSION_MAJOR 0
+#define CONTRACT_LIB_VERSION_MINOR 2
+#define CONTRACT_LIB_VERSION_PATCH 3
+
+#define CONTRACT_LIB_VERSION_STRING \
+    __ct_stringify__(CONTRACT_LIB_VERSION_MAJOR) "." \
+    __ct_stringify__(CONTRACT_LIB_VERSION_MINOR) "." \
+    __ct_stringify__(CONTRACT_LIB_VERSION_PATCH)
+
+#define CONTRACT_LIB_VERSION \
+    CONTRACT_LIB_VERSION_MAJOR * 10000 + \
+    CONTRACT_LIB_VERSION_MINOR * 100 + \
+    CONTRACT_LIB_VERSION_PATCH
+
+/***************************************************************************/
+
+// interface: macros
+//
+
+// Define contract block.
+//
+// This macro defines a contract block for a specified `scope`.
+//
+// @scope  the scope of the contract:
+//             `fun`     - defines a free function contract,
+//             `mfun`    - defines a contract for a member-function,
+//             `ctor`    - defines a contract for a constructor,
+//             `dtor`    - defines a contract for a destructor,
+//             `loop`    - defines a loop invariant contract,
+//             `class`   - defines a contract for a class,
+//             `derived` - defines a contract for a derived class.
+// @option the evaluation option of a `class` or `derived` contract:
+//             `budget(us)` - sheds invariant checks on a thread once they
+//                            took more than `us` microseconds per second,
+//                            see <contract/budget.hpp>.
+//                        Without an option the class invariant is checked on
+//                        the spot;
+//         the option of a `loop` contract:
+//             `deferred`   - the block encloses the loop and reports the first
+//                            violation of its `LOOP_INVARIANT(...)` checks
+//                            after the loop, see `LOOP_INVARIANT(...)`.
+#define CONTRACT(...) \
+    __ct_concat__(__ct_contract, __ct_arg_count__(__VA_ARGS__))(__VA_ARGS__)
+#define __ct_contract1(scope) __ct_contract_ ## scope ## __
+#define __ct_contract2(scope, option) \
+    __ct_contract_ ## scope ## _option__(__ct_option_ ## option)
+
+// Select the contract policy.
+//
+// This macro selects the contract policy used by all contract blocks and
+// contract checks that are defined in the enclosing namespace or class, unless
+// a nested namespace or class selects its own.  Contract blocks outside of any
+// such scope use <contract::default_policy>.
+//
+// @policy  the policy type; see <contract::default_policy> for the members a
+//          policy has to provide.
+#define CONTRACT_POLICY(...) \
+    using contract_policy__ = __VA_ARGS__
+
+// Exception specification of a function whose contract can't throw.
+//
+// Expands to `noexcept(true)` if the contract policy in scope is `nothrow`
+// (see <contract::default_policy>) and to `noexcept(false)` otherwise, so a
+// move constructor with a contract is `noexcept`, and used by `std::vector`
+// on reallocation, whenever its contract checks don't throw:
+//
+//     buffer(buffer && other) CONTRACT_NOEXCEPT { CONTRACT(ctor) { ... }; ... }
+#define CONTRACT_NOEXCEPT \
+    noexcept(::contract::detail::is_nothrow_policy<contract_policy__>::value)
+
+// Declare a contract module.
+//
+// This macro declares the contract module `name` in the enclosing namespace and
+// selects its policy (see `CONTRACT_POLICY(...)`) for that namespace.  The
+// module configuration becomes a template argument of every contract defined
+// in the module, so modules configured differently never share contract
+// instantiations, and a module can't be declared twice in the same namespace
+// with different configurations.
+//
+// @name    the name of the module.
+// @policy  the policy that configures the checks of the module, for example
+//          `contract::check_policy<true, false, false>`;  defaults to
+//          <contract::default_policy>.
+#define CONTRACT_MODULE(...) \
+    __ct_concat__(CONTRACT_MODULE, __ct_arg_count__(__VA_ARGS__))(__VA_ARGS__)
+#define CONTRACT_MODULE1(name) \
+    __ct_contract_module__(name, ::contract::default_policy)
+#define CONTRACT_MODULE2(name, ...) __ct_contract_module__(name, __VA_ARGS__)
+#define CONTRACT_MODULE3(name, ...) __ct_contract_module__(name, __VA_ARGS__)
+#define CONTRACT_MODULE4(name, ...) __ct_contract_module__(name, __VA_ARGS__)
+#define CONTRACT_MODULE5(name, ...) __ct_contract_module__(name, __VA_ARGS__)
+
+// Define precondition contract.
+//
+// This macro defines a precondition check for a contract block defined by the
+// `contract(...)` macro.  Precondition is checked in the following situations:
+//   `fun`   - on function entry,
+//   `mfun`  - on member-function entry,
+//   `ctor`  - on constructor entry,
+//   `dtor`  - on destructor entry,
+//   `loop`  - not checked.
+//
+// @cond  precondition expression that should evalate to `true`.
+// @msg   message which is reported to the contract violation handler if `cond`
+//        evaluates to `false`.  It may also be a format string literal followed
+//        by up to 14 arguments, like `"index {} out of [0, {})", i, n`, which
+//        are only evaluated and formatted on violation, see
+//        `__ct_format_message__`.
+//
+// Use macro `CONTRACT_DISABLE_PRECONDITIONS` to disable precondition checking,
+// or `CONTRACT_ASSUME_PRECONDITIONS` to turn preconditions into optimizer hints
+// (see `__ct_assume__`).
+#define PRECONDITION(...) \
+    __ct_concat__(PRECONDITION, __ct_msg_arity__(__VA_ARGS__))(__VA_ARGS__)
+#define PRECONDITION1(cond) PRECONDITION2(cond, #cond)
+#define PRECONDITIONN(cond, fmt, ...) PRECONDITION2(cond, __ct_format_message__(fmt, __VA_ARGS__))
+
+#if defined(CONTRACT_ASSUME_PRECONDITIONS)
+#	define PRECONDITION2(cond, msg) \
+        __ct_contract_assume__(precondition, cond)
+#elif !defined(CONTRACT_DISABLE_PRECONDITIONS)
+#	define PRECONDITION2(cond, msg) \
+        __ct_contract_check__(precondition, cond, msg)
+#else
+#	define PRECONDITION2(cond, msg) \
+        do {} while (false && (cond))
+#endif
+
+// Define postcondition contract.
+//
+// This macro defines a postcondition check for a contract block defined by the
+// `contract(...)` macro.  Precondition is checked in the following situations:
+//   `fun`   - on function exit,
+//   `mfun`  - on member-function exit,
+//   `ctor`  - on constructor exit,
+//   `dtor`  - on destructor exit,
+//   `loop`  - not checked.
+//
+// @cond  postcondition expression that should evalate to `true`.
+// @msg   message which is reported to the contract violation handler if `cond`
+//        evaluates to `false`.  It may also be a format string literal followed
+//        by up to 14 arguments, like `"index {} out of [0, {})", i, n`, which
+//        are only evaluated and formatted on violation, see
+//        `__ct_format_message__`.
+//
+// Use macro `CONTRACT_DISABLE_POSTCONDITIONS` to disable precondition checking,
+// or `CONTRACT_ASSUME_POSTCONDITIONS` to turn postconditions into optimizer
+// hints (see `__ct_assume__`).
+#define POSTCONDITION(...) \
+    __ct_concat__(POSTCONDITION, __ct_msg_arity__(__VA_ARGS__))(__VA_ARGS__)
+#define POSTCONDITION1(cond) POSTCONDITION2(cond, #cond)
+#define POSTCONDITIONN(cond, fmt, ...) POSTCONDITION2(cond, __ct_format_message__(fmt, __VA_ARGS__))
+
+#if defined(CONTRACT_ASSUME_POSTCONDITIONS)
+#	define POSTCONDITION2(cond, msg) \
+        __ct_contract_assume__(postcondition, cond)
+#elif !defined(CONTRACT_DISABLE_POSTCONDITIONS)
+#	define POSTCONDITION2(cond, msg) \
+        __ct_contract_check__(postcondition, cond, msg)
+#else
+#	define POSTCONDITION2(cond, msg) \
+        do {} while (false && (cond))
+#endif
+
+// Define invariant contract.
+//
+// This macro defines an invariant check for a contract block defined by the
+// `contract(...)` macro.  Invariant is checked in the following situations:
+//   `fun`     - on function entry and exit,
+//   `mfun`    - on member-function entry and exit,
+//   `ctor`    - on constructor exit,
+//   `dtor`    - on destructor entry,
+//   `loop`    - on each loop iteration,
+//   `class`   - on entry and exit of each method with a `contract(this) block,
+//               on exit of constructors with a `contract(ctor)` block, unless
+//                  an exception is thrown,
+//               on entry to destructors with a `contract(dtor)` block,
+//   `derived` - on entry and exit of each method with a `contract(this) block,
+//               on exit of constructors with a `contract(ctor)` block unless
+//                  an exception is thrown,
+//               on entry to destructors with a `contract(dtor)` block.
+//
+// @cond  postcondition expression that should evalate to `true`.
+// @msg   message which is reported to the contract violation handler if `cond`
+//        evaluates to `false`.  It may also be a format string literal followed
+//        by up to 14 arguments, like `"index {} out of [0, {})", i, n`, which
+//        are only evaluated and formatted on violation, see
+//        `__ct_format_message__`.
+//
+// Use macro `CONTRACT_DISABLE_INVARIANTS` to disable precondition checking,
+// or `CONTRACT_ASSUME_INVARIANTS` to turn invariants into optimizer hints
+// (see `__ct_assume__`).
+#define INVARIANT(...) \
+    __ct_concat__(INVARIANT, __ct_msg_arity__(__VA_ARGS__))(__VA_ARGS__)
+#define INVARIANT1(cond) INVARIANT2(cond, #cond)
+#define INVARIANTN(cond, fmt, ...) INVARIANT2(cond, __ct_format_message__(fmt, __VA_ARGS__))
+
+#if defined(CONTRACT_ASSUME_INVARIANTS)
+#	define INVARIANT2(cond, msg) \
+        __ct_contract_assume__(invariant, cond)
+#elif !defined(CONTRACT_DISABLE_INVARIANTS)
+#	define INVARIANT2(cond, msg) \
+        __ct_contract_check__(invariant, cond, msg)
+#else
+#	define INVARIANT2(cond, msg) \
+        do {} while (false && (cond))
+#endif
+
+// Define deferred loop invariant contract.
+//
+// This macro defines a loop invariant check inside a deferred loop contract
+// block, `CONTRACT(loop, deferred) { for (...) { ... } };`, which encloses
+// the loop.  Instead of reporting a violation on the spot, every iteration
+// folds the result of the check into the block with a branch-free minimum of
+// the failed iteration numbers, so the enclosing loop stays vectorizable with
+// the baseline SIMD of the target.  The fold is 32 bits wide, so iteration
+// numbers are reported modulo 2^31.  With a policy whose `loop_iterations` is
+// `false` only a failure flag is folded, which is cheaper still.
+// When the block ends after the loop, the violation of the earliest failed
+// iteration, if any, is reported once with its iteration number in
+// <violation_context::iteration>.  Each check is counted once per run of the
+// loop.  A block holds up to `CONTRACT_LOOP_CHECKS` checks.
+//
+// @iter  the iteration number, an unsigned integer convertible to
+//        `std::uint64_t`, usually the loop index.
+// @cond  invariant expression that should evaluate to `true`; evaluated on
+//        every iteration, so it should be cheap and free of side effects.
+// @msg   message which is reported to the contract violation handler if `cond`
+//        evaluates to `false`.
+//
+// Use macro `CONTRACT_DISABLE_INVARIANTS` to disable loop invariant checking.
+#define LOOP_INVARIANT(...) \
+    __ct_concat__(LOOP_INVARIANT, __ct_arg_count__(__VA_ARGS__))(__VA_ARGS__)
+#define LOOP_INVARIANT2(iter, cond) LOOP_INVARIANT3(iter, cond, #cond)
+
+#if !defined(CONTRACT_DISABLE_INVARIANTS) && !defined(CONTRACT_ASSUME_INVARIANTS)
+#	define LOOP_INVARIANT3(iter, cond, msg) \
+        __ct_loop_invariant__(iter, cond, msg)
+#else
+#	define LOOP_INVARIANT3(iter, cond, msg) \
+        do {} while (false && ((iter) || (cond)))
+#endif
+
+// Define comparison contract checks.
+//
+// These macros define precondition, postcondition and invariant checks of the
+// comparison `a OP b`, where `OP` is `==` (`EQ`), `!=` (`NE`), `<` (`LT`),
+// `<=` (`LE`), `>` (`GT`) or `>=` (`GE`).  Each operand is evaluated once.  If
+// the comparison fails, the operand values are captured into the `lhs` and
+// `rhs` members of the <violation_context> (see <contract::captured_value>),
+// so the handler can report them.
+//
+// @a    left operand.
+// @b    right operand.
+// @msg  message which is reported to the contract violation handler if the
+//       comparison fails; a format with arguments like for `PRECONDITION`.
+//
+// The macros are disabled and assumed like `PRECONDITION(...)`,
+// `POSTCONDITION(...)` and `INVARIANT(...)`.
+#define PRECONDITION_EQ(...)  __ct_contract_cmp__(precondition, ==, __VA_ARGS__)
+#define PRECONDITION_NE(...)  __ct_contract_cmp__(precondition, !=, __VA_ARGS__)
+#define PRECONDITION_LT(...)  __ct_contract_cmp__(precondition, <, __VA_ARGS__)
+#define PRECONDITION_LE(...)  __ct_contract_cmp__(precondition, <=, __VA_ARGS__)
+#define PRECONDITION_GT(...)  __ct_contract_cmp__(precondition, >, __VA_ARGS__)
+#define PRECONDITION_GE(...)  __ct_contract_cmp__(precondition, >=, __VA_ARGS__)
+#define POSTCONDITION_EQ(...) __ct_contract_cmp__(postcondition, ==, __VA_ARGS__)
+#define POSTCONDITION_NE(...) __ct_contract_cmp__(postcondition, !=, __VA_ARGS__)
+#define POSTCONDITION_LT(...) __ct_contract_cmp__(postcondition, <, __VA_ARGS__)
+#define POSTCONDITION_LE(...) __ct_contract_cmp__(postcondition, <=, __VA_ARGS__)
+#define POSTCONDITION_GT(...) __ct_contract_cmp__(postcondition, >, __VA_ARGS__)
+#define POSTCONDITION_GE(...) __ct_contract_cmp__(postcondition, >=, __VA_ARGS__)
+#define INVARIANT_EQ(...)     __ct_contract_cmp__(invariant, ==, __VA_ARGS__)
+#define INVARIANT_NE(...)     __ct_contract_cmp__(invariant, !=, __VA_ARGS__)
+#define INVARIANT_LT(...)     __ct_contract_cmp__(invariant, <, __VA_ARGS__)
+#define INVARIANT_LE(...)     __ct_contract_cmp__(invariant, <=, __VA_ARGS__)
+#define INVARIANT_GT(...)     __ct_contract_cmp__(invariant, >, __VA_ARGS__)
+#define INVARIANT_GE(...)     __ct_contract_cmp__(invariant, >=, __VA_ARGS__)
+
+#if defined(CONTRACT_ASSUME_PRECONDITIONS)
+#	define __ct_precondition_cmp__(OP, A, B, MSG) \
+        __ct_contract_assume__(precondition, (A) OP (B))
+#elif !defined(CONTRACT_DISABLE_PRECONDITIONS)
+#	define __ct_precondition_cmp__(OP, A, B, MSG) \
+        __ct_contract_check_cmp__(precondition, OP, A, B, MSG)
+#else
+#	define __ct_precondition_cmp__(OP, A, B, MSG) \
+        do {} while (false && ((A) OP (B)))
+#endif
+
+#if defined(CONTRACT_ASSUME_POSTCONDITIONS)
+#	define __ct_postcondition_cmp__(OP, A, B, MSG) \
+        __ct_contract_assume__(postcondition, (A) OP (B))
+#elif !defined(CONTRACT_DISABLE_POSTCONDITIONS)
+#	define __ct_postcondition_cmp__(OP, A, B, MSG) \
+        __ct_contract_check_cmp__(postcondition, OP, A, B, MSG)
+#else
+#	define __ct_postcondition_cmp__(OP, A, B, MSG) \
+        do {} while (false && ((A) OP (B)))
+#endif
+
+#if defined(CONTRACT_ASSUME_INVARIANTS)
+#	define __ct_invariant_cmp__(OP, A, B, MSG) \
+        __ct_contract_assume__(invariant, (A) OP (B))
+#elif !defined(CONTRACT_DISABLE_INVARIANTS)
+#	define __ct_invariant_cmp__(OP, A, B, MSG) \
+        __ct_contract_check_cmp__(invariant, OP, A, B, MSG)
+#else
+#	define __ct_invariant_cmp__(OP, A, B, MSG) \
+        do {} while (false && ((A) OP (B)))
+#endif
+
+/***************************************************************************/
+
+// implementation: macros
+//
+
+// Comparison check dispatch on the presence of the message.
+#define __ct_contract_cmp__(TYPE, OP, ...) \
+    __ct_concat__(__ct_contract_cmp, __ct_cmp_arity__(__VA_ARGS__))(TYPE, OP, __VA_ARGS__)
+#define __ct_contract_cmp2(TYPE, OP, A, B) \
+    __ct_contract_cmp3(TYPE, OP, A, B, #A " " #OP " " #B)
+#define __ct_contract_cmp3(TYPE, OP, A, B, MSG) \
+    __ct_ ## TYPE ## _cmp__(OP, A, B, MSG)
+#define __ct_contract_cmpN(TYPE, OP, A, B, FMT, ...) \
+    __ct_contract_cmp3(TYPE, OP, A, B, __ct_format_message__(FMT, __VA_ARGS__))
+
+// Message formatted from the format string literal `FMT` and the arguments.
+// The format is checked against the number of arguments at compile time; the
+// arguments are only evaluated and formatted when the check fails, into a
+// per-thread buffer of `CONTRACT_MESSAGE_SIZE` characters that is reused by
+// the next formatted message of the thread.
+#define __ct_format_message__(FMT, ...) \
+    (::contract::detail::message_format< \
+        ::contract::detail::message_placeholders(FMT) \
+        ,decltype(::contract::detail::message_arguments(__VA_ARGS__))::value \
+    >::format(FMT, __VA_ARGS__))
+
+// Declare a contract module tag and select the module policy.
+#define __ct_contract_module__(name, ...) \
+    struct name ## _contract_module__; \
+    CONTRACT_POLICY(::contract::module_policy<name ## _contract_module__, __VA_ARGS__>)
+
+// Define contract for a free function.
+#define __ct_contract_fun__ \
+    auto contract_obj__ = ::contract::basic_contractor<contract_policy__>(0) \
+    + [&](::contract::detail::contract_context const & __CT_UNUSED(contract_context__))
+
+// Define contract for a member function.
+#define __ct_contract_mfun__ \
+    auto contract_obj__ = ::contract::basic_contractor< \
+        contract_policy__ \
+        ,::contract::detail::this_class<decltype(*this)> \
+    >(this) \
+    + [&](::contract::detail::contract_context const & __CT_UNUSED(contract_context__))
+
+// Define contract for a constructor.
+#define __ct_contract_ctor__ \
+    auto contract_obj__ = ::contract::basic_contractor< \
+        contract_policy__ \
+        ,::contract::detail::this_class<decltype(*this)> \
+    >(this, false, true) \
+    + [&](::contract::detail::contract_context const & __CT_UNUSED(contract_context__))
+
+// Define contract for a destructor.
+#define __ct_contract_dtor__ \
+    auto contract_obj__ = ::contract::basic_contractor< \
+        contract_policy__ \
+        ,::contract::detail::this_class<decltype(*this)> \
+    >(this, true, false) \
+    + [&](::contract::detail::contract_context const & __CT_UNUSED(contract_context__))
+
+// Define a class contract.  Without an option the invariant is checked on the
+// spot; the alias hides any option of a base class contract.
+#define __ct_contract_class__ \
+    __ct_contract_class_option__(::contract::detail::immediate_option)
+
+// Define a class contract evaluated by `contract_option__`.
+#define __ct_contract_class_block__ \
+    template <typename, typename> \
+    friend struct ::contract::detail::class_contract_base; \
+    \
+    template <typename T> \
+    friend struct ::contract::detail::has_class_contract; \
+    \
+    template <typename ...Bases> \
+    friend struct ::contract::detail::base_class_contract; \
+    \
+    friend struct ::contract::detail::class_contract_access; \
+    \
+    using contract_bases__ = ::contract::detail::type_list<>; \
+    \
+    ::contract::detail::contract_context prepare_contract__( \
+        ::contract::detail::contract_context const & __CT_UNUSED(contract_context__)) const \
+    { \
+        return contract_context__; \
+    } \
+    \
+    void class_contract__(::contract::detail::contract_context const & __CT_UNUSED(contract_context__)) const
+
+// Define a derived class contract.  Without an option the invariant is checked
+// on the spot, whatever the options of the base class contracts.
+#define __ct_contract_derived__ \
+    __ct_contract_derived_option__(::contract::detail::immediate_option)
+
+// Define a derived class contract evaluated by `contract_option__`.
+#define __ct_contract_derived_block__(...) \
+    template <typename, typename> \
+    friend struct ::contract::detail::class_contract_base; \
+    \
+    template <typename T> \
+    friend struct ::contract::detail::has_class_contract; \
+    \
+    template <typename ...Bases> \
+    friend struct ::contract::detail::base_class_contract; \
+    \
+    friend struct ::contract::detail::class_contract_access; \
+    \
+    using contract_bases__ = ::contract::detail::type_list<__VA_ARGS__>; \
+    \
+    ::contract::detail::contract_context prepare_contract__( \
+        ::contract::detail::contract_context const & __CT_UNUSED(contract_context__)) const \
+    { \
+        ::contract::detail::base_class_contract<__VA_ARGS__>::enforce(this, contract_context__); \
+        return contract_context__; \
+    } \
+    \
+    void class_contract__(::contract::detail::contract_context const & __CT_UNUSED(contract_context__)) const
+
+
+// Define a class contract with an evaluation option.
+#define __ct_contract_class_option__(OPTION) \
+    using contract_option__ = OPTION; \
+    __ct_contract_class_block__
+
+// Define a derived class contract with an evaluation option.
+#define __ct_contract_derived_option__(OPTION) \
+    using contract_option__ = OPTION; \
+    __ct_contract_derived_block__
+
+// Define a loop invariant contract.
+#define __ct_contract_loop__ \
+    if (::contract::detail::contract_context contract_context__{false, false, true})
+
+// Define a deferred loop invariant contract enclosing the loop.  The counter
+// numbers the `LOOP_INVARIANT(...)` checks of the block.
+#define __ct_contract_loop_option__(OPTION) \
+    if (::contract::detail::loop_contract<__ct_loop_policy__, OPTION, __COUNTER__> \
+            contract_loop__{})
+
+// Evaluation option for `CONTRACT(class, deferred)`, see
+// <contract/deferred.hpp>, and `CONTRACT(loop, deferred)`.
+#define __ct_option_deferred ::contract::detail::deferred_option
+
+// Deferred loop invariant check implementation.  The site is a constant, so
+// it costs nothing per iteration.
+#define __ct_loop_invariant__(ITER, COND, MSG) \
+    do { \
+        if (contract_policy__::invariants) { \
+            static constexpr ::contract::detail::loop_site contract_loop_site__{ \
+                __ct_loop_site__(#COND, MSG)}; \
+            contract_loop__.template check<__COUNTER__>( \
+                static_cast<::contract::detail::loop_iteration>(ITER) \
+                ,static_cast<bool>(COND) \
+                ,contract_loop_site__); \
+        } \
+    } while (0)
+
+// Compile-time id of the contract check with the condition string `COND` on
+// the current line.
+#define __ct_site_id__(COND) \
+    ::contract::detail::site_constant< \
+        ::contract::detail::site_id(__FILE__, __LINE__, COND) \
+    >::value
+
+// Whether the contract check with the condition string `COND` on the current
+// line is evaluated this time, at the level set by `CONTRACT_SITE_CONFIG`.
+#if defined(CONTRACT_SITE_CONFIG)
+#	define __ct_site_enabled__(COND) \
+        ::contract::detail::site_enabled<__ct_site_id__(COND)>()
+#else
+#	define __ct_site_enabled__(COND) true
+#endif
+
+#if !defined(__ct_quick_enforce__)
+
+// Policy of deferred loop contract blocks and the site of their checks.
+#define __ct_loop_policy__ contract_policy__
+#define __ct_loop_site__(COND, MSG) __ct_check_site__(invariant, COND), MSG
+
+// Contract check main implementation.
+#define __ct_contract_check__(TYPE, COND, MSG) \
+    do { \
+        if (contract_policy__::TYPE ## s && contract_context__.check_ ## TYPE() \
+            && __ct_site_enabled__(#COND)) { \
+            if (::contract::detail::check_probe<contract_policy__> contract_probe__{ \
+                    __ct_check_site__(TYPE, #COND)}) { \
+                if (!(COND) || __ct_inject_fault__(__ct_check_site__(TYPE, #COND))) \
+                    contract_policy__::handle( \
+                        ::contract::violation_context( \
+                            ::contract::type::TYPE \
+                            ,MSG \
+                            ,#COND \
+                            ,__FILE__ \
+                            ,__LINE__ \
+                            ,__ct_site_id__(#COND) \
+                        ) \
+                    ); \
+            } \
+        } \
+    } while (0)
+
+// Whether to report a violation of the contract check `SITE` even though its
+// condition holds, see <contract/fault_injection.hpp>.
+#if defined(CONTRACT_FAULT_INJECTION)
+#	define __ct_inject_fault__(SITE) ::contract::detail::inject_fault(SITE)
+#else
+#	define __ct_inject_fault__(SITE) false
+#endif
+
+// Description of the contract check of type `TYPE` with the condition string
+// `COND` on the current line.
+#define __ct_check_site__(TYPE, COND) \
+    ::contract::check_site{ \
+        __ct_site_id__(COND) \
+        ,::contract::type::TYPE \
+        ,__FILE__ \
+        ,__LINE__ \
+        ,COND \
+    }
+
+// Comparison check implementation: the operands are evaluated once and
+// captured only when the comparison fails.
+#define __ct_contract_check_cmp__(TYPE, OP, A, B, MSG) \
+    do { \
+        if (contract_policy__::TYPE ## s && contract_context__.check_ ## TYPE() \
+            && __ct_site_enabled__(#A " " #OP " " #B)) { \
+            if (::contract::detail::check_probe<contract_policy__> contract_probe__{ \
+                    __ct_check_site__(TYPE, #A " " #OP " " #B)}) { \
+                auto const & contract_lhs__ = (A); \
+                auto const & contract_rhs__ = (B); \
+                if (!(contract_lhs__ OP contract_rhs__) \
+                    || __ct_inject_fault__(__ct_check_site__(TYPE, #A " " #OP " " #B))) \
+                    contract_policy__::handle( \
+                        ::contract::violation_context( \
+                            ::contract::type::TYPE \
+                            ,MSG \
+                            ,#A " " #OP " " #B \
+                            ,__FILE__ \
+                            ,__LINE__ \
+                            ,::contract::captured_value(contract_lhs__) \
+                            ,::contract::captured_value(contract_rhs__) \
+                            ,__ct_site_id__(#A " " #OP " " #B) \
+                        ) \
+                    ); \
+            } \
+        } \
+    } while (0)
+
+#else // __ct_quick_enforce__
+
+// Deferred loop contract blocks fold a failure flag and trap after the loop;
+// their sites hold no strings.
+#define __ct_loop_policy__ ::contract::detail::quick_enforce_policy<contract_policy__>
+#define __ct_loop_site__(COND, MSG) \
+    ::contract::check_site{0, ::contract::type::invariant, nullptr, 0, nullptr}, nullptr
+
+// Quick-enforce contract check implementation: the message is dropped unused.
+#define __ct_contract_check__(TYPE, COND, MSG) \
+    do { \
+        if (contract_policy__::TYPE ## s && contract_context__.check_ ## TYPE() \
+            && __ct_site_enabled__(#COND) && !(COND)) \
+            __ct_trap__(); \
+    } while (0)
+
+// Quick-enforce comparison check implementation.
+#define __ct_contract_check_cmp__(TYPE, OP, A, B, MSG) \
+    do { \
+        if (contract_policy__::TYPE ## s && contract_context__.check_ ## TYPE() \
+            && __ct_site_enabled__(#A " " #OP " " #B) && !((A) OP (B))) \
+            __ct_trap__(); \
+    } while (0)
+
+#endif // __ct_quick_enforce__
+
+// Tell the optimizer that `COND` holds without checking it.
+//
+// Only the forms that never evaluate the condition are used by default, so a
+// condition with side effects (or an expensive call) costs nothing and changes
+// nothing at run time.  Compilers that have no such form (GCC before 13) get
+// the plain disabled check unless `CONTRACT_ASSUME_UNREACHABLE` is defined, in
+// which case the condition is evaluated and its failure marked unreachable:
+// only define it if all assumed conditions are free of side effects.
+#if defined(__has_cpp_attribute)
+#  if __has_cpp_attribute(assume) && __cplusplus > 202002L
+#    define __ct_assume_attribute__
+#  endif
+#endif
+
+#if defined(__ct_assume_attribute__)
+#  define __ct_assume__(COND) [[assume(COND)]]
+#elif defined(__clang__)
+#  define __ct_assume__(COND) __builtin_assume(COND)
+#elif defined(_MSC_VER)
+#  define __ct_assume__(COND) __assume(COND)
+#elif defined(__GNUC__) && defined(CONTRACT_ASSUME_UNREACHABLE)
+#  define __ct_assume__(COND) if (!(COND)) __builtin_unreachable()
+#else
+#  define __ct_assume__(COND) do {} while (false && (COND))
+#endif
+
+// Contract assumption main implementation.
+#define __ct_contract_assume__(TYPE, COND) \
+    do { \
+        if (contract_context__.check_ ## TYPE()) \
+            __ct_assume__(COND); \
+    } while (0)
+
+/***************************************************************************/
+
+#endif // __contract_macros_hpp__included
@@ -0,0 +1,377 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef __contract_metrics_hpp__included
+#define __contract_metrics_hpp__included
+
+/***************************************************************************/
+
+#include <contract/contract.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/***************************************************************************/
+
+// Number of check sites the shared-memory metrics segment has counters for.
+// Further sites are only counted in <metrics_header::overflow>.
+#if !defined(CONTRACT_METRICS_SITES)
+#	define CONTRACT_METRICS_SITES 1024
+#endif
+
+/***************************************************************************/
+
+namespace contract {
+
+// interface: shared-memory metrics layout
+//
+
+// The metrics segment is a POSIX shared-memory object made of a
+// <metrics_header> followed by `capacity` <metrics_site> slots.  Slots are
+// claimed in the order the sites are first evaluated.  The site id of a slot
+// is written last, so a slot whose id is 0 is not in use yet.  Counters are
+// updated with relaxed atomic increments; readers may see them a little out
+// of date but never torn.  All integers are in the byte order of the host.
+
+struct metrics_header {
+    enum: std::uint32_t {
+         magic_value   = 0x544d5443  // "CTMT"
+        ,version_value = 1
+    };
+
+    std::uint32_t magic;          // <magic_value>
+    std::uint32_t version;        // <version_value>
+    std::uint32_t capacity;       // number of site slots
+    std::uint32_t site_size;      // size of a site slot in bytes
+    std::uint64_t pid;            // id of the process
+    std::uint64_t used;           // number of claimed site slots
+    std::uint64_t overflow;       // evaluations of sites without a slot
+    unsigned char reserved[24];
+};
+
+struct metrics_site {
+    std::uint64_t site;           // site id of the check; 0 if not in use yet
+    std::uint64_t evaluations;    // number of evaluations of the check
+    std::uint64_t violations;     // number of violations of the check
+    std::uint32_t line;           // line of the check
+    std::uint8_t  contract_type;  // <contract::type> of the check
+    unsigned char reserved[3];
+    char file[96];                // truncated, NUL-terminated
+    char condition[128];          // truncated, NUL-terminated
+};
+
+static_assert(sizeof(metrics_header) == 64, "bad metrics header layout");
+static_assert(sizeof(metrics_site) == 256, "bad metrics site layout");
+
+// interface: shared-memory metrics
+//
+
+// Open the shared-memory metrics segment of this process.
+//
+// Create the POSIX shared-memory object `name` (by default "/contract-<pid>",
+// which is what `contract-top <pid>` attaches to) and count the evaluations
+// and violations of contract checks using <metrics_policy> in it from now on.
+// A segment that is already open is closed first.  Opening and closing must
+// not race with counting.
+//
+// @name     name of the shared-memory object, or `nullptr` for the default.
+// @returns  `false` if the segment can't be created.
+__ct_decl__ bool open_metrics(char const * name = nullptr);
+
+// Close and remove the shared-memory metrics segment.
+__ct_decl__ void close_metrics();
+
+// Count an evaluation of the contract check `site`.  Does nothing if no
+// metrics segment is open.
+__ct_decl__ void count_evaluation(check_site const & site) noexcept;
+
+// Count a violation of a contract check.  Does nothing if no metrics segment
+// is open.
+__ct_decl__ void count_violation(violation_context const & context) noexcept;
+
+// Write the counters of the metrics segment of this process to `out`, one
+// line per site:
+//
+//     <site id> <type> <evaluations> <violations> <file>:<line> <condition>
+//
+// The site id is in hexadecimal, the other numbers in decimal.
+__ct_decl__ void dump_metrics(std::ostream & out);
+
+// Contract policy that counts evaluations and violations of every check in
+// the metrics segment, then reports violations like <default_policy>.
+struct metrics_policy: default_policy {
+    static void count(check_site const & site) noexcept {
+        count_evaluation(site);
+    }
+
+    [[noreturn]]
+    static void handle(violation_context const & context) {
+        count_violation(context);
+        default_policy::handle(context);
+    }
+};
+
+// Keeps the metrics segment of this process open while any instance exists;
+// the first one opens it with the default name and the last one closes it.
+// Instrumented builds (`CONTRACT_INSTRUMENTED`) have one in every translation
+// unit including this header, so the segment is open from static
+// initialization to exit without any code in the program.
+struct __ct_decl__ metrics_session {
+    metrics_session();
+    ~metrics_session();
+
+    metrics_session(metrics_session const &) = delete;
+    metrics_session & operator=(metrics_session const &) = delete;
+};
+
+/***************************************************************************/
+
+#if defined(__ct_compile_library__)
+
+namespace detail {
+
+// implementation: shared-memory metrics
+//
+
+// Holder for the mapped metrics segment and the map from site ids to their
+// slots.  Templated with a dummy type to be able to keep it in the header
+// file.
+template <typename = void>
+struct metrics_holder {
+    static_assert((CONTRACT_METRICS_SITES & (CONTRACT_METRICS_SITES - 1)) == 0,
+                  "CONTRACT_METRICS_SITES must be a power of two");
+
+    // the map has twice as many entries as there are slots
+    static constexpr std::size_t map_size = 2 * CONTRACT_METRICS_SITES;
+
+    static std::atomic<char *> base;
+    static char name[64];
+
+    // number of live <metrics_session> objects
+    static std::atomic<int> sessions;
+
+    // site ids and 1 + their slot index; the index is 0 while the slot is
+    // being claimed
+    static std::atomic<std::uint64_t> ids[map_size];
+    static std::atomic<std::uint32_t> slots[map_size];
+};
+
+template <typename T>
+constexpr std::size_t metrics_holder<T>::map_size;
+
+template <typename T>
+std::atomic<char *> metrics_holder<T>::base{nullptr};
+
+template <typename T>
+char metrics_holder<T>::name[64];
+
+template <typename T>
+std::atomic<int> metrics_holder<T>::sessions{0};
+
+template <typename T>
+std::atomic<std::uint64_t> metrics_holder<T>::ids[metrics_holder<T>::map_size];
+
+template <typename T>
+std::atomic<std::uint32_t> metrics_holder<T>::slots[metrics_holder<T>::map_size];
+
+inline
+std::size_t metrics_size() noexcept {
+    return sizeof(metrics_header) + CONTRACT_METRICS_SITES * sizeof(metrics_site);
+}
+
+inline
+metrics_site * metrics_slot(char * base, std::uint32_t index) noexcept {
+    return reinterpret_cast<metrics_site *>(
+        base + sizeof(metrics_header) + index * sizeof(metrics_site));
+}
+
+// Find the slot of the site `id`, claiming one for `site` if `site` is given.
+// Returns `nullptr` if the site has no slot (yet).
+inline
+metrics_site * metrics_find(char * base, std::uint64_t id, check_site const * site) noexcept {
+    using holder = metrics_holder<>;
+
+    for (std::size_t i = 0; i != holder::map_size; ++i) {
+        std::size_t const at = (id + i) & (holder::map_size - 1);
+        std::uint64_t seen = holder::ids[at].load(std::memory_order_acquire);
+
+        if (seen == 0) {
+            if (!site || !holder::ids[at].compare_exchange_strong(seen, id))
+                return nullptr;
+
+            metrics_header * header = reinterpret_cast<metrics_header *>(base);
+            std::uint64_t const index =
+                __atomic_fetch_add(&header->used, 1, __ATOMIC_RELAXED);
+            if (index >= header->capacity)
+                return nullptr;
+
+            metrics_site * slot = metrics_slot(base, static_cast<std::uint32_t>(index));
+            slot->line = static_cast<std::uint32_t>(site->line);
+            slot->contract_type = static_cast<std::uint8_t>(site->contract_type);
+            format_buffer{slot->file, sizeof(slot->file)}.put(site->file);
+            format_buffer{slot->condition, sizeof(slot->condition)}.put(site->condition);
+            __atomic_store_n(&slot->site, id, __ATOMIC_RELEASE);
+
+            holder::slots[at].store(static_cast<std::uint32_t>(index + 1),
+                                    std::memory_order_release);
+            return slot;
+        }
+
+        if (seen == id) {
+            std::uint32_t const index = holder::slots[at].load(std::memory_order_acquire);
+            return index != 0 ? metrics_slot(base, index - 1) : nullptr;
+        }
+    }
+
+    return nullptr;
+}
+
+} // namespace detail
+
+/***************************************************************************/
+
+__ct_inline__
+bool open_metrics(char const * name) {
+    using holder = detail::metrics_holder<>;
+
+    close_metrics();
+
+    if (name)
+        detail::format_buffer{holder::name, sizeof(holder::name)}.put(name);
+    else
+        detail::format_buffer{holder::name, sizeof(holder::name)}
+            .put("/contract-").put_unsigned(static_cast<unsigned long long>(::getpid()));
+
+    int const fd = ::shm_open(holder::name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return false;
+
+    std::size_t const size = detail::metrics_size();
+    void * map = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<::off_t>(size)) == 0)
+        map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (map == MAP_FAILED) {
+        ::shm_unlink(holder::name);
+        return false;
+    }
+
+    metrics_header * header = static_cast<metrics_header *>(map);
+    header->magic = metrics_header::magic_value;
+    header->version = metrics_header::version_value;
+    header->capacity = CONTRACT_METRICS_SITES;
+    header->site_size = sizeof(metrics_site);
+    header->pid = static_cast<std::uint64_t>(::getpid());
+
+    for (std::atomic<std::uint64_t> & id: holder::ids)
+        id.store(0, std::memory_order_relaxed);
+    for (std::atomic<std::uint32_t> & slot: holder::slots)
+        slot.store(0, std::memory_order_relaxed);
+
+    holder::base.store(static_cast<char *>(map));
+    return true;
+}
+
+__ct_inline__
+void close_metrics() {
+    using holder = detail::metrics_holder<>;
+
+    char * base = holder::base.exchange(nullptr);
+    if (base) {
+        // a forked child leaves the segment of its parent in place
+        bool const owner =
+            reinterpret_cast<metrics_header *>(base)->pid == static_cast<std::uint64_t>(::getpid());
+        ::munmap(base, detail::metrics_size());
+        if (owner)
+            ::shm_unlink(holder::name);
+    }
+}
+
+__ct_inline__
+void count_evaluation(check_site const & site) noexcept {
+    char * base = detail::metrics_holder<>::base.load(std::memory_order_acquire);
+    if (!base)
+        return;
+
+    metrics_site * slot = detail::metrics_find(base, site.id, &site);
+    if (slot)
+        __atomic_fetch_add(&slot->evaluations, 1, __ATOMIC_RELAXED);
+    else
+        __atomic_fetch_add(&reinterpret_cast<metrics_header *>(base)->overflow,
+                           1, __ATOMIC_RELAXED);
+}
+
+__ct_inline__
+void count_violation(violation_context const & context) noexcept {
+    char * base = detail::metrics_holder<>::base.load(std::memory_order_acquire);
+    if (!base)
+        return;
+
+    metrics_site * slot = detail::metrics_find(base, context.site, nullptr);
+    if (slot)
+        __atomic_fetch_add(&slot->violations, 1, __ATOMIC_RELAXED);
+}
+
+__ct_inline__
+void dump_metrics(std::ostream & out) {
+    char * base = detail::metrics_holder<>::base.load(std::memory_order_acquire);
+    if (!base)
+        return;
+
+    metrics_header const * header = reinterpret_cast<metrics_header const *>(base);
+    std::uint64_t used = __atomic_load_n(&header->used, __ATOMIC_RELAXED);
+    if (used > header->capacity)
+        used = header->capacity;
+
+    for (std::uint32_t i = 0; i != used; ++i) {
+        metrics_site const * slot = detail::metrics_slot(base, i);
+        std::uint64_t const id = __atomic_load_n(&slot->site, __ATOMIC_ACQUIRE);
+        if (id == 0)
+            continue;
+
+        out << std::hex << id << std::dec << ' '
+            << detail::type_name(static_cast<type>(slot->contract_type)) << ' '
+            << __atomic_load_n(&slot->evaluations, __ATOMIC_RELAXED) << ' '
+            << __atomic_load_n(&slot->violations, __ATOMIC_RELAXED) << ' '
+            << slot->file << ':' << slot->line << ' '
+            << slot->condition << '\n';
+    }
+}
+
+__ct_inline__
+metrics_session::metrics_session() {
+    if (detail::metrics_holder<>::sessions++ == 0)
+        open_metrics();
+}
+
+__ct_inline__
+metrics_session::~metrics_session() {
+    if (--detail::metrics_holder<>::sessions == 0)
+        close_metrics();
+}
+
+#endif // __ct_compile_library__
+
+#if defined(CONTRACT_INSTRUMENTED)
+namespace {
+metrics_session const instrumented_session__;
+} // anon namespace
+#endif
+
+} // namespace contract
+
+/***************************************************************************/
+
+#endif // __contract_metrics_hpp__included
@@ -0,0 +1,197 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef __contract_parallel_hpp__included
+#define __contract_parallel_hpp__included
+
+/***************************************************************************/
+
+#include <contract/contract.hpp>
+#include <contract/detail/work_stealing_pool.hpp>
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/***************************************************************************/
+
+// Number of worker threads checking parallel class invariants; 0 means one per
+// hardware thread.
+#if !defined(CONTRACT_PARALLEL_THREADS)
+#	define CONTRACT_PARALLEL_THREADS 0
+#endif
+
+// implementation: macros
+//
+
+// Evaluation option for `CONTRACT(class, parallel)`.
+#define __ct_option_parallel ::contract::detail::parallel_option
+
+/***************************************************************************/
+
+namespace contract {
+namespace detail {
+
+// implementation: code behind macros
+//
+
+// Holder for the worker threads of parallel invariant checks.
+// Templated with a dummy type to be able to keep it in the header file.
+template <typename = void>
+struct parallel_holder {
+    static
+    work_stealing_pool & workers() {
+        static work_stealing_pool pool{CONTRACT_PARALLEL_THREADS != 0
+                                    ? CONTRACT_PARALLEL_THREADS
+                                    : std::thread::hardware_concurrency()};
+        return pool;
+    }
+};
+
+// Group of tasks run on a thread pool and joined together.  The joining
+// thread runs pending tasks of the pool while it waits, so nested groups can't
+// starve the pool.  The first exception thrown by a task is rethrown by
+// <wait>.
+class task_group {
+public:
+    explicit
+    task_group(work_stealing_pool & pool)
+        :pool_(pool)
+        ,pending_{0}
+    {}
+
+    task_group(task_group const &) = delete;
+    task_group & operator=(task_group const &) = delete;
+
+    void run(std::function<void ()> f) {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            ++pending_;
+        }
+
+        pool_.submit([this, f] {
+            __ct_try__ {
+                f();
+            } __ct_catch_all__ {
+                std::lock_guard<std::mutex> lock{mutex_};
+                if (!error_)
+                    error_ = std::current_exception();
+            }
+
+            // notify under the lock: the group may be gone once it's released
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (--pending_ == 0)
+                done_.notify_all();
+        });
+    }
+
+    void wait() {
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock{mutex_};
+                if (pending_ == 0)
+                    break;
+            }
+
+            // the queues are empty, so the remaining tasks are being run by
+            // the workers
+            if (!pool_.run_pending()) {
+                std::unique_lock<std::mutex> lock{mutex_};
+                done_.wait(lock, [this] { return pending_ == 0; });
+                break;
+            }
+        }
+
+        if (error_)
+            std::rethrow_exception(error_);
+    }
+
+private:
+    work_stealing_pool & pool_;
+    std::mutex mutex_;
+    std::condition_variable done_;
+    std::size_t pending_;
+    std::exception_ptr error_;
+};
+
+// Spawns the slices of the invariant checks of an invariant block, each as a
+// task with a context made from the `suppressed` mask of the calling thread.
+template <typename F>
+void spawn_slices(task_group & group, std::size_t slices, unsigned suppressed, F check) {
+    for (std::size_t i = 0; i != slices; ++i) {
+        group.run([=] {
+            check_slice slice{i, slices, 0};
+            check(contract_context{false, false, true, nullptr, suppressed, &slice});
+        });
+    }
+}
+
+// Spawns the invariant checks of the base class subobjects at the ends of
+// the `Paths` of a derived class.
+template <typename Paths>
+struct parallel_bases;
+
+template <>
+struct parallel_bases<type_list<>> {
+    template <typename T>
+    static
+    void spawn(task_group &, std::size_t, unsigned, T const *) {}
+};
+
+template <typename Path, typename ...Paths>
+struct parallel_bases<type_list<Path, Paths...>> {
+    template <typename T>
+    static
+    void spawn(task_group & group, std::size_t slices, unsigned suppressed, T const * obj) {
+        spawn_slices(group, slices, suppressed, [obj](contract_context const & context) {
+            base_class_contract<>::enforce_path(obj, context, Path{});
+        });
+
+        parallel_bases<type_list<Paths...>>::spawn(group, slices, suppressed, obj);
+    }
+};
+
+// Class contract evaluation option that checks the invariant checks of the
+// class and of each of the base classes enforced by a derived class contract
+// as independent tasks on a pool of worker threads, and joins them before
+// returning.  Each invariant block is split into one slice of its checks per
+// worker and one for the calling thread (see <check_slice>); every slice
+// runs the block and evaluates its own checks only, so the code of a block
+// besides its checks runs once per slice.  The contexts carry the
+// suppression mask of the calling thread.  Violations are reported on the
+// worker threads; an exception thrown by the violation handler there is
+// rethrown on the calling thread.
+struct parallel_option {
+    template <typename T>
+    static
+    void evaluate(T const * obj, void (*)(T const *), bool /*exit*/) {
+        work_stealing_pool & workers = parallel_holder<>::workers();
+        std::size_t const slices = workers.size() + 1;
+        unsigned const suppressed = suppress_holder<>::mask();
+        task_group group{workers};
+
+        using paths = typename base_contract_paths<
+            typename contract_bases<T>::type
+        >::type;
+
+        parallel_bases<paths>::spawn(group, slices, suppressed, obj);
+        spawn_slices(group, slices, suppressed, [obj](contract_context const & context) {
+            class_contract_access::invariant(obj, context);
+        });
+
+        group.wait();
+    }
+};
+
+} // namespace detail
+} // namespace contract
+
+/***************************************************************************/
+
+#endif // __contract_parallel_hpp__included
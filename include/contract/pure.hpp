@@ -0,0 +1,166 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef __contract_pure_hpp__included
+#define __contract_pure_hpp__included
+
+/***************************************************************************/
+
+#include <contract/contract.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+/***************************************************************************/
+
+// Number of entries of the per-thread pure predicate cache; a power of two.
+#if !defined(CONTRACT_PURE_CACHE_SIZE)
+#	define CONTRACT_PURE_CACHE_SIZE 256
+#endif
+
+// interface: macros
+//
+
+// Define precondition contract with a memoized pure predicate.
+//
+// This macro defines a precondition check that calls `pred(args...)`, like
+// `PRECONDITION(pred(args...))`, but remembers the successful results in a
+// small per-thread direct-mapped cache keyed by the check and a hash of the
+// arguments.  Repeated checks with the same arguments skip the predicate call.
+// Only use it with predicates whose result depends on nothing but their
+// arguments, such as checks of immutable configuration.  Failed results are
+// not cached.  Two argument lists with the same hash are considered equal, so
+// the arguments should be cheap to hash and unlikely to collide.
+//
+// @pred  predicate callable with `args...`, returning a value convertible to
+//        `bool`.
+// @args  arguments of the predicate; hashed with `std::hash`.
+//
+// Use macro `CONTRACT_DISABLE_PRECONDITIONS` to disable precondition checking,
+// or `CONTRACT_ASSUME_PRECONDITIONS` to turn preconditions into optimizer hints.
+#if defined(CONTRACT_ASSUME_PRECONDITIONS)
+#	define PRECONDITION_PURE(pred, ...) \
+        __ct_contract_assume__(precondition, (pred)(__VA_ARGS__))
+#elif !defined(CONTRACT_DISABLE_PRECONDITIONS)
+#	define PRECONDITION_PURE(pred, ...) \
+        __ct_contract_check_pure__(precondition, pred, __VA_ARGS__)
+#else
+#	define PRECONDITION_PURE(pred, ...) \
+        do {} while (false && (pred)(__VA_ARGS__))
+#endif
+
+// implementation: macros
+//
+
+#if !defined(__ct_quick_enforce__)
+
+// Memoized contract check implementation.  The address of the local static
+// identifies the check in the cache.
+#define __ct_contract_check_pure__(TYPE, PRED, ...) \
+    do { \
+        static char const contract_site__ = 0; \
+        if (contract_policy__::TYPE ## s && contract_context__.check_ ## TYPE() \
+            && __ct_site_enabled__(#PRED "(" #__VA_ARGS__ ")")) { \
+            if (::contract::detail::check_probe<contract_policy__> contract_probe__{ \
+                    __ct_check_site__(TYPE, #PRED "(" #__VA_ARGS__ ")")}) { \
+                if (!::contract::detail::pure_check(&contract_site__, PRED, __VA_ARGS__) \
+                    || __ct_inject_fault__(__ct_check_site__(TYPE, #PRED "(" #__VA_ARGS__ ")"))) \
+                    contract_policy__::handle( \
+                        ::contract::violation_context( \
+                            ::contract::type::TYPE \
+                            ,#PRED "(" #__VA_ARGS__ ")" \
+                            ,#PRED "(" #__VA_ARGS__ ")" \
+                            ,__FILE__ \
+                            ,__LINE__ \
+                            ,__ct_site_id__(#PRED "(" #__VA_ARGS__ ")") \
+                        ) \
+                    ); \
+            } \
+        } \
+    } while (0)
+
+#else // __ct_quick_enforce__
+
+// Quick-enforce memoized contract check implementation.
+#define __ct_contract_check_pure__(TYPE, PRED, ...) \
+    do { \
+        static char const contract_site__ = 0; \
+        if (contract_policy__::TYPE ## s && contract_context__.check_ ## TYPE() \
+            && __ct_site_enabled__(#PRED "(" #__VA_ARGS__ ")") \
+            && !::contract::detail::pure_check(&contract_site__, PRED, __VA_ARGS__)) \
+            __ct_trap__(); \
+    } while (0)
+
+#endif // __ct_quick_enforce__
+
+/***************************************************************************/
+
+namespace contract {
+namespace detail {
+
+// implementation: code behind macros
+//
+
+// Per-thread direct-mapped cache of successful pure predicate results.
+// Templated with a dummy type to be able to keep it in the header file.
+template <typename = void>
+struct pure_cache {
+    static_assert((CONTRACT_PURE_CACHE_SIZE & (CONTRACT_PURE_CACHE_SIZE - 1)) == 0,
+                  "CONTRACT_PURE_CACHE_SIZE must be a power of two");
+
+    struct entry {
+        void const * site;
+        std::uint64_t hash;
+    };
+
+    static
+    entry & lookup(void const * site, std::uint64_t hash) {
+        static thread_local entry entries[CONTRACT_PURE_CACHE_SIZE];
+
+        std::uint64_t const key =
+            hash ^ (static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(site))
+                    * 0x9e3779b97f4a7c15ull);
+        return entries[(key ^ (key >> 29)) & (CONTRACT_PURE_CACHE_SIZE - 1)];
+    }
+};
+
+inline
+std::uint64_t pure_hash(std::uint64_t seed) { return seed; }
+
+template <typename Arg, typename ...Args>
+std::uint64_t pure_hash(std::uint64_t seed, Arg const & arg, Args const & ...args) {
+    std::uint64_t const h = std::hash<typename std::decay<Arg>::type>{}(arg);
+    seed ^= h + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+    return pure_hash(seed, args...);
+}
+
+// Call `pred(args...)` unless it has already succeeded on this thread for the
+// check `site` with the same arguments.
+template <typename Pred, typename ...Args>
+bool pure_check(void const * site, Pred && pred, Args const & ...args) {
+    std::uint64_t const hash = pure_hash(0, args...);
+    pure_cache<>::entry & e = pure_cache<>::lookup(site, hash);
+
+    if (e.site == site && e.hash == hash)
+        return true;
+
+    if (!pred(args...))
+        return false;
+
+    e.site = site;
+    e.hash = hash;
+    return true;
+}
+
+} // namespace detail
+} // namespace contract
+
+/***************************************************************************/
+
+#endif // __contract_pure_hpp__included
@@ -0,0 +1,25 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// The compiled contract library: defines the violation handler, the
+// shared-memory metrics, the binary violation log, fault injection and the
+// crash handler once for programs built with `CONTRACT_SEPARATE_COMPILATION`,
+// see <contract/contract.hpp>.
+
+#if !defined(CONTRACT_SEPARATE_COMPILATION)
+#	define CONTRACT_SEPARATE_COMPILATION
+#endif
+#define CONTRACT_SOURCE
+
+#include <contract/contract.hpp>
+#include <contract/crash_handler.hpp>
+#include <contract/fault_injection.hpp>
+
+#if !defined(_WIN32)
+#	include <contract/binary_log.hpp>
+#	include <contract/metrics.hpp>
+#endif
@@ -0,0 +1,48 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Interface of the `contract` C++20 module: the declarations of
+// <contract/contract.hpp>.  Macros don't cross module boundaries, so a
+// translation unit using the module includes the preprocessor layer on its own:
+//
+//     import contract;
+//     #include <contract/macros.hpp>
+//
+// Configuration macros that change declarations rather than checks (sizes,
+// `CONTRACT_SEMANTIC`, `CONTRACT_SEPARATE_COMPILATION`) must be the same for
+// the module and the translation units importing it.  The declarations are
+// attached to the global module, so the module and translation units that
+// include the header share the handler and the rest of the state.
+
+module;
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+export module contract;
+
+#define CONTRACT_MODULE_INTERFACE
+
+extern "C++" {
+#include <contract/contract.hpp>
+}
+
+// the per-thread suppression mask and message buffer are defined here only:
+// importers that inline a reference to a thread-local variable instantiated by
+// the module lose its TLS model (GCC 12).  tests/module/thread_local.cmake
+// checks that every holder of thread-local state is listed here
+template struct contract::detail::suppress_holder<void>;
+template struct contract::detail::message_holder<void>;
@@ -0,0 +1,20 @@
+TEMPLATE = lib
+TARGET = contract
+CONFIG += c++11
+CONFIG -= qt
+
+QMAKE_CXXFLAGS += \
+	-std=c++11
+
+DEFINES += \
+	CONTRACT_SEPARATE_COMPILATION
+
+INCLUDEPATH += \
+	../include
+
+SOURCES += \
+	contract.cpp
+
+LIBS += \
+	-lrt \
+	-pthread
@@ -0,0 +1,117 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <contract/contract.hpp>
+#include <contract/adaptive.hpp>
+#include <contract/pure.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <cstdint>
+
+namespace {
+
+namespace observed {
+
+// Observe-mode policy: remembers the last counted check and counts the
+// reported violations.
+struct observe_policy: contract::default_policy {
+    static void count(contract::check_site const & site) noexcept {
+        counted = site.id;
+    }
+
+    static void handle(contract::violation_context const &) noexcept {
+        ++violations;
+    }
+
+    static std::uint64_t counted;
+    static int violations;
+};
+
+std::uint64_t observe_policy::counted = 0;
+int observe_policy::violations = 0;
+
+CONTRACT_POLICY(contract::adaptive_policy<1000, 10, observe_policy>);
+
+bool spin(int value) {
+    auto const stop = std::chrono::steady_clock::now() + std::chrono::microseconds(1);
+    while (std::chrono::steady_clock::now() < stop)
+        ;
+    return value >= 0;
+}
+
+// the check takes nearly all of the call
+int expensive(int value) {
+    CONTRACT(fun) { PRECONDITION(spin(value)); };
+    return value;
+}
+
+// the check takes a tiny part of the call
+int cheap(int value) {
+    CONTRACT(fun) { PRECONDITION(value >= 0); };
+    spin(value);
+    return value;
+}
+
+// the memoized check misses the cache and takes nearly all of the call
+int expensive_pure(int value) {
+    CONTRACT(fun) { PRECONDITION_PURE(spin, value); };
+    return value;
+}
+
+} // namespace observed
+
+using observed::observe_policy;
+
+std::uint64_t site_of(int (*fun)(int)) {
+    fun(0);
+    return observe_policy::counted;
+}
+
+} // anon namespace
+
+BOOST_AUTO_TEST_CASE(adaptive_demote_expensive) {
+    std::uint64_t const site = site_of(observed::expensive);
+    BOOST_CHECK_EQUAL(contract::adaptive_stride(site), 1u);
+
+    for (int i = 0; i != 20000; ++i)
+        observed::expensive(i);
+
+    // expect the check to be demoted more than once
+    BOOST_CHECK(contract::adaptive_stride(site) >= 4u);
+    BOOST_CHECK_EQUAL(observe_policy::violations, 0);
+
+    // expect a violation to restore full checking
+    for (int i = 0; i != 1000000 && observe_policy::violations == 0; ++i)
+        observed::expensive(-1);
+    BOOST_CHECK_EQUAL(observe_policy::violations, 1);
+    BOOST_CHECK_EQUAL(contract::adaptive_stride(site), 1u);
+
+    observed::expensive(-1);
+    BOOST_CHECK_EQUAL(observe_policy::violations, 2);
+}
+
+BOOST_AUTO_TEST_CASE(adaptive_keep_cheap) {
+    std::uint64_t const site = site_of(observed::cheap);
+
+    for (int i = 0; i != 20000; ++i)
+        observed::cheap(i);
+
+    BOOST_CHECK_EQUAL(contract::adaptive_stride(site), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(adaptive_demote_pure) {
+    std::uint64_t const site = site_of(observed::expensive_pure);
+    BOOST_CHECK_EQUAL(contract::adaptive_stride(site), 1u);
+
+    for (int i = 1; i != 20000; ++i)
+        observed::expensive_pure(i);
+
+    // expect memoized checks to be probed like the others
+    BOOST_CHECK(contract::adaptive_stride(site) >= 4u);
+}
@@ -0,0 +1,62 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#define CONTRACT_ASSUME_PRECONDITIONS
+#include <contract/contract.hpp>
+
+#include "contract_error.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+
+int assume_side_effects = 0;
+
+int test_assume_preconditions(int n)
+{
+    CONTRACT(fun) { PRECONDITION(n % 4 == 0); };
+
+    return n / 4;
+}
+
+void test_assume_preconditions_side_effect()
+{
+    CONTRACT(fun) { PRECONDITION(++assume_side_effects != 0); };
+}
+
+void test_assume_preconditions_postcondition()
+{
+    CONTRACT(fun) { POSTCONDITION(false); };
+}
+
+void test_assume_preconditions_invariant()
+{
+    CONTRACT(fun) { INVARIANT(false); };
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(macro_assume_preconditions)
+{
+    test::contract_handler_frame cframe;
+
+    // expect assumed precondition to hold
+    BOOST_CHECK_EQUAL(test_assume_preconditions(8), 2);
+
+    // expect assumed condition to be never evaluated
+    BOOST_CHECK_NO_THROW(test_assume_preconditions_side_effect());
+    BOOST_CHECK_EQUAL(assume_side_effects, 0);
+
+    // expect postcondition to fail
+    BOOST_CHECK_THROW(test_assume_preconditions_postcondition(),
+                      test::contract_error);
+
+    // expect invariant to fail
+    BOOST_CHECK_THROW(test_assume_preconditions_invariant(),
+                      test::contract_error);
+}
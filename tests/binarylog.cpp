@@ -0,0 +1,161 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <contract/contract.hpp>
+#include <contract/binary_log.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+namespace observed {
+
+CONTRACT_POLICY(::contract::log_policy);
+
+int clamp(int value, int limit) {
+    CONTRACT(fun) {
+        PRECONDITION_LE(value, limit, "value over limit");
+    };
+
+    return value < limit ? value : limit;
+}
+
+} // namespace observed
+
+struct log_file {
+    log_file() {
+        char name[] = "/tmp/contract-log-XXXXXX";
+        int const fd = ::mkstemp(name);
+        ::close(fd);
+        ::unlink(name);
+        path = name;
+    }
+
+    ~log_file() {
+        contract::close_violation_log();
+        std::remove(path.c_str());
+    }
+
+    std::vector<char> read() const {
+        std::ifstream in{path, std::ios::binary};
+        return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    }
+
+    std::string path;
+};
+
+template <typename Record>
+Record record_at(std::vector<char> const & log, std::size_t slot) {
+    Record record;
+    std::memcpy(&record, &log[slot * contract::log_header::slot_size], sizeof(record));
+    return record;
+}
+
+// Number of slots describing the site of `observed::clamp`, which depends on
+// the length of the path of this file.
+std::size_t site_slots() {
+    std::size_t const size = std::strlen(__FILE__) + sizeof("value <= limit")
+                           + sizeof("value over limit");
+    std::size_t const text = sizeof(contract::log_site::text);
+    return 1 + (size > text ? (size - text + contract::log_header::slot_size - 1)
+                              / contract::log_header::slot_size
+                            : 0);
+}
+
+} // anon namespace
+
+BOOST_AUTO_TEST_CASE(binary_log_records) {
+    log_file file;
+    BOOST_REQUIRE(contract::open_violation_log(file.path.c_str(), 4096));
+
+    // expect the execution to continue in observe mode
+    BOOST_CHECK_EQUAL(observed::clamp(5, 10), 5);
+    BOOST_CHECK_EQUAL(observed::clamp(15, 10), 10);
+    BOOST_CHECK_EQUAL(observed::clamp(20, 10), 10);
+    contract::close_violation_log();
+
+    std::vector<char> const log = file.read();
+    BOOST_REQUIRE_EQUAL(log.size(), 4096u);
+
+    auto const header = record_at<contract::log_header>(log, 0);
+    BOOST_CHECK_EQUAL(header.magic, contract::log_header::magic_value);
+    BOOST_CHECK_EQUAL(header.tail, (3 + site_slots()) * contract::log_header::slot_size);
+    BOOST_CHECK_EQUAL(header.dropped, 0u);
+
+    // expect the site to be described once, before its first event; the text
+    // continues in the following slots
+    auto const site = record_at<contract::log_site>(log, 1);
+    BOOST_CHECK(site.kind == static_cast<std::uint8_t>(contract::log_record_kind::site));
+    BOOST_CHECK_EQUAL(site.slots + 1u, site_slots());
+    BOOST_CHECK_EQUAL(site.line, 30u);
+    BOOST_CHECK_NE(site.site, 0u);
+    char const * path = &log[2 * contract::log_header::slot_size - sizeof(site.text)];
+    BOOST_CHECK_EQUAL(std::string(path), __FILE__);
+    char const * condition = path + std::strlen(path) + 1;
+    BOOST_CHECK_EQUAL(std::string(condition), "value <= limit");
+    BOOST_CHECK_EQUAL(std::string(condition + std::strlen(condition) + 1), "value over limit");
+
+    auto const first = record_at<contract::log_event>(log, 1 + site_slots());
+    auto const second = record_at<contract::log_event>(log, 2 + site_slots());
+    BOOST_CHECK(first.kind == static_cast<std::uint8_t>(contract::log_record_kind::event));
+    BOOST_CHECK_EQUAL(first.site, site.site);
+    BOOST_CHECK_EQUAL(second.site, site.site);
+    BOOST_CHECK(first.contract_type == static_cast<std::uint8_t>(contract::type::precondition));
+    BOOST_CHECK(second.time >= first.time);
+    BOOST_CHECK_EQUAL(first.thread, second.thread);
+
+    auto const lhs = contract::captured_value::from_bytes(
+        static_cast<contract::captured_value::kind>(second.lhs_kind),
+        second.lhs, second.lhs_size);
+    char value[32];
+    lhs.format(value, sizeof(value));
+    BOOST_CHECK_EQUAL(std::string(value), "20");
+}
+
+BOOST_AUTO_TEST_CASE(binary_log_append_and_drop) {
+    log_file file;
+    // room for the header, the site and one event, then the site again
+    std::size_t const slots = 2 + 2 * site_slots();
+    BOOST_REQUIRE(contract::open_violation_log(file.path.c_str(), slots * 64));
+    observed::clamp(15, 10);
+    contract::close_violation_log();
+
+    // expect an existing log to be appended to, with its own capacity
+    BOOST_REQUIRE(contract::open_violation_log(file.path.c_str(), 4096));
+    observed::clamp(15, 10);
+    observed::clamp(15, 10);
+    contract::close_violation_log();
+
+    std::vector<char> const log = file.read();
+    BOOST_REQUIRE_EQUAL(log.size(), slots * 64);
+
+    auto const header = record_at<contract::log_header>(log, 0);
+    // expect the site to be described again in the reopened log, and both
+    // events not to fit after that
+    BOOST_CHECK_EQUAL(header.dropped, 2u);
+    BOOST_CHECK(record_at<contract::log_site>(log, 2 + site_slots()).kind ==
+                static_cast<std::uint8_t>(contract::log_record_kind::site));
+}
+
+BOOST_AUTO_TEST_CASE(site_ids) {
+    // expect the site ids to be compile-time constants that tell sites apart
+    constexpr std::uint64_t a = contract::detail::site_id("a.cpp", 1, "x > 0");
+    constexpr std::uint64_t b = contract::detail::site_id("a.cpp", 2, "x > 0");
+    constexpr std::uint64_t c = contract::detail::site_id("b.cpp", 1, "x > 0");
+    constexpr std::uint64_t d = contract::detail::site_id("a.cpp", 1, "x > 1");
+    static_assert(a != b && a != c && a != d && b != c, "site ids collide");
+    BOOST_CHECK_NE(a, 0u);
+}
@@ -0,0 +1,143 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <contract/contract.hpp>
+#include <contract/budget.hpp>
+
+#include "contract_error.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+
+namespace {
+
+// Spin for `us` microseconds.
+bool spin(long us) {
+    auto const stop = std::chrono::steady_clock::now() + std::chrono::microseconds(us);
+    while (std::chrono::steady_clock::now() < stop)
+        ;
+    return true;
+}
+
+class order_book
+{
+public:
+    int size() const
+    {
+        CONTRACT(mfun) {};
+        return size_;
+    }
+
+    void size(int sz)
+    {
+        CONTRACT(mfun) {};
+        size_ = sz;
+    }
+
+private:
+    // expensive invariant: 200us per check within a budget of 500us per second
+    CONTRACT(class, budget(500))
+    {
+        INVARIANT(spin(200));
+        INVARIANT(size_ >= 0);
+    };
+
+    int size_ = 0;
+};
+
+class base_book
+{
+private:
+    CONTRACT(class) { INVARIANT(level_ >= 0); };
+
+protected:
+    int level_ = 0;
+};
+
+class derived_book : public base_book
+{
+public:
+    void level(int lvl)
+    {
+        CONTRACT(mfun) {};
+        level_ = lvl;
+    }
+
+private:
+    CONTRACT(derived, budget(1000))(base_book) { INVARIANT(true); };
+};
+
+int heavy_checks = 0;
+
+// base class contract with a budget that the derived class doesn't select
+class budget_base
+{
+private:
+    CONTRACT(class, budget(1)) { INVARIANT(true); };
+};
+
+class unbudgeted_derived : public budget_base
+{
+public:
+    void touch() const
+    {
+        CONTRACT(mfun) {};
+    }
+
+private:
+    CONTRACT(derived)(budget_base) { INVARIANT(spin(20) && ++heavy_checks); };
+};
+
+} // anon namespace
+
+BOOST_AUTO_TEST_CASE(budget_shed_expensive_invariant) {
+    test::contract_handler_frame cframe;
+
+    order_book book;
+    contract::budget_report const before = contract::get_budget_report();
+
+    // 100 checks of 200us each can't fit the budget
+    for (int i = 0; i != 50; ++i)
+        BOOST_CHECK_EQUAL(book.size(), 0);
+
+    contract::budget_report const after = contract::get_budget_report();
+    BOOST_CHECK(after.shed - before.shed > 0);
+    BOOST_CHECK(after.checked - before.checked > 0);
+    BOOST_CHECK_EQUAL((after.shed - before.shed) + (after.checked - before.checked), 100u);
+}
+
+BOOST_AUTO_TEST_CASE(budget_check_cheap_invariant) {
+    test::contract_handler_frame cframe;
+
+    derived_book book;
+    contract::budget_report const before = contract::get_budget_report();
+
+    // cheap invariants always fit the budget
+    BOOST_CHECK_NO_THROW(book.level(1));
+
+    contract::budget_report const after = contract::get_budget_report();
+    BOOST_CHECK_EQUAL(after.shed - before.shed, 0u);
+    BOOST_CHECK_EQUAL(after.checked - before.checked, 2u);
+
+    // expect base class invariant to fail on exit
+    BOOST_CHECK_THROW(book.level(-1), test::contract_error);
+}
+
+BOOST_AUTO_TEST_CASE(budget_not_inherited_by_derived) {
+    test::contract_handler_frame cframe;
+
+    unbudgeted_derived object;
+    heavy_checks = 0;
+
+    // the derived contract has no option: every check runs despite the budget
+    // of the base class contract
+    for (int i = 0; i != 100; ++i)
+        object.touch();
+
+    BOOST_CHECK_EQUAL(heavy_checks, 200);
+}
@@ -0,0 +1,141 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <contract/contract.hpp>
+
+#include "contract_error.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+namespace {
+
+enum class side { buy = 1, sell = 2 };
+
+struct order {
+    int qty;
+    side s;
+    std::string symbol;
+};
+
+void submit(order const & o, std::size_t limit) {
+    CONTRACT(fun) {
+        PRECONDITION_GT(o.qty, 0);
+        PRECONDITION_LE(static_cast<std::size_t>(o.qty), limit, "order over limit");
+        PRECONDITION_EQ(o.s, side::buy);
+        PRECONDITION_NE(o.symbol, "HALT");
+    };
+}
+
+std::string format(contract::captured_value const & value) {
+    char buf[64];
+    value.format(buf, sizeof(buf));
+    return buf;
+}
+
+template <typename Func>
+contract::violation_context catch_violation(Func f) {
+    try {
+        f();
+    } catch (test::contract_error & e) {
+        return e.context();
+    }
+
+    BOOST_FAIL("expected to catch test::contract_error");
+    return contract::violation_context{contract::type::precondition, "", "", "", 0};
+}
+
+} // anon namespace
+
+BOOST_AUTO_TEST_CASE(compare_checks_pass) {
+    test::contract_handler_frame cframe;
+
+    BOOST_CHECK_NO_THROW(submit(order{5, side::buy, "ACME"}, 10));
+}
+
+BOOST_AUTO_TEST_CASE(compare_checks_capture_operands) {
+    test::contract_handler_frame cframe;
+
+    contract::violation_context c = catch_violation(
+        []{ submit(order{-3, side::buy, "ACME"}, 10); });
+    BOOST_CHECK_EQUAL(c.condition, "o.qty > 0");
+    BOOST_CHECK_EQUAL(c.message, "o.qty > 0");
+    BOOST_CHECK_EQUAL(format(c.lhs), "-3");
+    BOOST_CHECK_EQUAL(format(c.rhs), "0");
+
+    contract::violation_context limit = catch_violation(
+        []{ submit(order{50, side::buy, "ACME"}, 10); });
+    BOOST_CHECK_EQUAL(limit.message, "order over limit");
+    BOOST_CHECK_EQUAL(format(limit.lhs), "50");
+    BOOST_CHECK(limit.rhs.get_kind() == contract::captured_value::kind::unsigned_integer);
+
+    contract::violation_context sell = catch_violation(
+        []{ submit(order{5, side::sell, "ACME"}, 10); });
+    BOOST_CHECK_EQUAL(format(sell.lhs), "2");
+    BOOST_CHECK_EQUAL(format(sell.rhs), "1");
+
+    contract::violation_context halt = catch_violation(
+        []{ submit(order{5, side::buy, "HALT"}, 10); });
+    BOOST_CHECK_EQUAL(format(halt.lhs), "\"HALT\"");
+    BOOST_CHECK_EQUAL(format(halt.rhs), "\"HALT\"");
+}
+
+BOOST_AUTO_TEST_CASE(captured_value_format) {
+    int x = 0;
+
+    BOOST_CHECK_EQUAL(format(contract::captured_value{true}), "true");
+    BOOST_CHECK_EQUAL(format(contract::captured_value{'q'}), "'q'");
+    BOOST_CHECK_EQUAL(format(contract::captured_value{-42L}), "-42");
+    BOOST_CHECK_EQUAL(format(contract::captured_value{18446744073709551615ull}),
+                      "18446744073709551615");
+    BOOST_CHECK_EQUAL(format(contract::captured_value{2.5}), "2.5");
+    BOOST_CHECK_EQUAL(format(contract::captured_value{-0.125f}), "-0.125");
+    BOOST_CHECK_EQUAL(format(contract::captured_value{1e20}), "1e20");
+    BOOST_CHECK_EQUAL(format(contract::captured_value{nullptr}), "nullptr");
+    BOOST_CHECK_EQUAL(format(contract::captured_value{&x}).substr(0, 2), "0x");
+    BOOST_CHECK_EQUAL(format(contract::captured_value{order{}}), "?");
+
+    // expect long strings to be truncated to the inline buffer
+    std::string const text(100, 'a');
+    std::string const expected =
+        '"' + std::string(CONTRACT_CAPTURE_TEXT_SIZE - 1, 'a') + "\"...";
+    BOOST_CHECK_EQUAL(format(contract::captured_value{text}), expected);
+    BOOST_CHECK_EQUAL(format(contract::captured_value{text.c_str()}), expected);
+
+    // expect the output to be cut to the buffer
+    char small[4];
+    BOOST_CHECK_EQUAL(contract::captured_value{123456}.format(small, sizeof(small)), 3u);
+    BOOST_CHECK_EQUAL(std::string(small), "123");
+}
+
+BOOST_AUTO_TEST_CASE(compare_invariant_and_postcondition) {
+    test::contract_handler_frame cframe;
+
+    test::check_throw_on_contract_violation(
+        []{
+            int n = 3;
+            CONTRACT(fun) {
+                POSTCONDITION_EQ(n, 4);
+                INVARIANT_GE(n, 0);
+            };
+            n = 5;
+        },
+        contract::type::postcondition,
+        "n == 4");
+
+    test::check_throw_on_contract_violation(
+        []{
+            for (int i = 0; i != 3; ++i) {
+                CONTRACT(loop) {
+                    INVARIANT_LT(i, 2);
+                };
+            }
+        },
+        contract::type::invariant,
+        "i < 2");
+}
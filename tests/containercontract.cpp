@@ -0,0 +1,195 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <contract/contract.hpp>
+#include <contract/containers.hpp>
+
+#include "contract_error.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct book {
+    contract::checked_vector<int> prices;
+    contract::checked_map<std::string, int> orders;
+
+    int total() const {
+        CONTRACT(mfun) {
+            INVARIANT_UNCHANGED(prices);
+            INVARIANT_UNCHANGED(orders);
+        };
+
+        int sum = 0;
+        for (int p: prices)
+            sum += p;
+        return sum;
+    }
+
+    // broken: claims to leave the prices alone
+    void reprice(std::size_t pos, int price) {
+        CONTRACT(mfun) {
+            INVARIANT_UNCHANGED(prices);
+        };
+
+        prices.set(pos, price);
+    }
+};
+
+void scan(std::vector<int> & v, bool touch) {
+    CONTRACT(fun) {
+        INVARIANT_UNCHANGED(v);
+    };
+
+    if (touch)
+        v[0] = -v[0];
+}
+
+// number of copies left before a copy of a <fragile> throws, negative to
+// never throw
+int copies_left = -1;
+
+void copied() {
+    if (copies_left >= 0 && copies_left-- == 0)
+        throw std::runtime_error{"copy failed"};
+}
+
+struct fragile {
+    fragile(int v)
+        :value{v}
+    {}
+
+    fragile(fragile const & other)
+        :value{other.value}
+    {
+        copied();
+    }
+
+    fragile & operator=(fragile const & other) {
+        copied();
+        value = other.value;
+        return *this;
+    }
+
+    int value;
+};
+
+} // anon namespace
+
+namespace std {
+
+template <>
+struct hash<fragile> {
+    std::size_t operator()(fragile const & f) const { return std::hash<int>{}(f.value); }
+};
+
+} // namespace std
+
+BOOST_AUTO_TEST_CASE(checked_vector_checksum) {
+    contract::checked_vector<int> v{1, 2, 3};
+    std::vector<int> plain{1, 2, 3};
+
+    // expect the incremental checksum to match the one of a plain range
+    BOOST_CHECK_EQUAL(v.checksum(), contract::checksum(plain));
+
+    v.push_back(4);
+    v.emplace_back(5);
+    v.pop_back();
+    v.set(0, 7);
+    v.modify(1, [](int & x) { x *= 10; });
+    v.insert(v.begin() + 1, 9);
+    v.erase(v.begin() + 3);
+
+    plain = {7, 9, 20, 4};
+    BOOST_CHECK(v.container() == plain);
+    BOOST_CHECK_EQUAL(v.checksum(), contract::checksum(plain));
+
+    // expect the order of the elements to matter
+    BOOST_CHECK(contract::checksum(std::vector<int>{1, 2}) !=
+                contract::checksum(std::vector<int>{2, 1}));
+
+    v.clear();
+    BOOST_CHECK_EQUAL(v.checksum(), contract::checksum(std::vector<int>{}));
+}
+
+BOOST_AUTO_TEST_CASE(checked_map_checksum) {
+    contract::checked_map<std::string, int> m{{"a", 1}, {"b", 2}};
+
+    std::uint64_t const initial = m.checksum();
+
+    m.assign("c", 3);
+    m.assign("a", 4);
+    m.modify("b", [](int & x) { ++x; });
+    BOOST_CHECK(!m.modify("z", [](int & x) { ++x; }));
+    BOOST_CHECK(m.checksum() != initial);
+
+    // expect the checksum to depend only on the contents
+    contract::checked_map<std::string, int> same{{"a", 4}, {"b", 3}, {"c", 3}};
+    BOOST_CHECK_EQUAL(m.checksum(), same.checksum());
+
+    BOOST_CHECK_EQUAL(m.erase("c"), 1u);
+    m.erase(m.find("a"));
+    m.emplace("a", 1);
+    m.insert({"b", 100});
+    m.assign("b", 2);
+    BOOST_CHECK_EQUAL(m.checksum(), initial);
+}
+
+BOOST_AUTO_TEST_CASE(checked_containers_exception_safety) {
+    contract::checked_vector<fragile> v{1, 2, 3, 4};
+
+    // expect the checksum to match the elements after a throwing change
+    BOOST_CHECK_THROW(v.modify(1, [](fragile & f) {
+        f.value = 20;
+        throw std::runtime_error{"modify failed"};
+    }), std::runtime_error);
+    BOOST_CHECK_EQUAL(v[1].value, 20);
+    BOOST_CHECK_EQUAL(v.checksum(), contract::checksum(v.container()));
+
+    // the second element moved down throws
+    copies_left = 1;
+    BOOST_CHECK_THROW(v.erase(v.begin()), std::runtime_error);
+    copies_left = -1;
+    BOOST_CHECK_EQUAL(v.checksum(), contract::checksum(v.container()));
+
+    contract::checked_map<int, int> m{{1, 1}, {2, 2}};
+    BOOST_CHECK_THROW(m.modify(2, [](int & x) {
+        x = 5;
+        throw std::runtime_error{"modify failed"};
+    }), std::runtime_error);
+    BOOST_CHECK_EQUAL(m.checksum(),
+                      (contract::checked_map<int, int>{m.container()}.checksum()));
+}
+
+BOOST_AUTO_TEST_CASE(invariant_unchanged) {
+    test::contract_handler_frame cframe;
+
+    book b;
+    b.prices = {1, 2, 3};
+    b.orders.assign("x", 1);
+
+    BOOST_CHECK_EQUAL(b.total(), 6);
+
+    test::check_throw_on_contract_violation(
+        [&b]{ b.reprice(0, 5); },
+        contract::type::invariant,
+        "prices changed");
+
+    std::vector<int> v{1, 2, 3};
+    BOOST_CHECK_NO_THROW(scan(v, false));
+    test::check_throw_on_contract_violation(
+        [&v]{ scan(v, true); },
+        contract::type::invariant,
+        "v changed");
+}
@@ -58,6 +58,7 @@ struct contract_error : std::exception {
 	 char const * condition() const { return context_.condition; }
 	 char const * file() const { return context_.file; }
 	 std::size_t line() const { return context_.line; }
+	 contract::violation_context const & context() const { return context_; }
 
 private:
 	 contract::violation_context context_;
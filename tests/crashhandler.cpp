@@ -0,0 +1,116 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <contract/contract.hpp>
+#include <contract/crash_handler.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <csignal>
+#include <cstring>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+namespace crashing {
+
+CONTRACT_POLICY(::contract::crash_policy);
+
+void withdraw(int balance, int amount) {
+    CONTRACT(fun) {
+        PRECONDITION_LE(amount, balance, "insufficient funds");
+    };
+}
+
+} // namespace crashing
+
+std::string read_all(int fd) {
+    std::string result;
+    char buf[256];
+
+    for (::ssize_t n; (n = ::read(fd, buf, sizeof(buf))) > 0;)
+        result.append(buf, static_cast<std::size_t>(n));
+
+    return result;
+}
+
+} // anon namespace
+
+BOOST_AUTO_TEST_CASE(crash_report_to_fd) {
+    int report[2];
+    int record[2];
+    BOOST_REQUIRE(::pipe(report) == 0);
+    BOOST_REQUIRE(::pipe(record) == 0);
+
+    int const old_fd = contract::set_crash_fd(report[1]);
+    int const old_record_fd = contract::set_crash_record_fd(record[1]);
+
+    contract::report_crash(contract::violation_context{
+        contract::type::precondition, "bad size", "n < 4", "file.cpp", 12,
+        contract::captured_value{7}, contract::captured_value{4}});
+
+    BOOST_CHECK_EQUAL(contract::set_crash_fd(old_fd), report[1]);
+    BOOST_CHECK_EQUAL(contract::set_crash_record_fd(old_record_fd), record[1]);
+    ::close(report[1]);
+    ::close(record[1]);
+
+    BOOST_CHECK_EQUAL(read_all(report[0]),
+        "file.cpp:12: error: contract violation of type 'precondition'\n"
+        "message:   bad size\n"
+        "condition: n < 4\n"
+        "lhs:       7\n"
+        "rhs:       4\n");
+
+    contract::crash_record r;
+    BOOST_REQUIRE_EQUAL(::read(record[0], &r, sizeof(r)), static_cast<::ssize_t>(sizeof(r)));
+    BOOST_CHECK_EQUAL(r.magic, contract::crash_record::magic_value);
+    BOOST_CHECK_EQUAL(r.version, contract::crash_record::version_value);
+    BOOST_CHECK_EQUAL(r.pid, static_cast<std::uint64_t>(::getpid()));
+    BOOST_CHECK_EQUAL(r.line, 12u);
+    BOOST_CHECK(r.contract_type == static_cast<std::uint8_t>(contract::type::precondition));
+    BOOST_CHECK_EQUAL(r.file, "file.cpp");
+    BOOST_CHECK_EQUAL(r.message, "bad size");
+    BOOST_CHECK_EQUAL(r.condition, "n < 4");
+    BOOST_CHECK_EQUAL(r.lhs, "7");
+    BOOST_CHECK_EQUAL(r.rhs, "4");
+
+    ::close(report[0]);
+    ::close(record[0]);
+}
+
+BOOST_AUTO_TEST_CASE(crash_policy_aborts) {
+    int report[2];
+    BOOST_REQUIRE(::pipe(report) == 0);
+
+    ::pid_t const pid = ::fork();
+    BOOST_REQUIRE(pid >= 0);
+
+    if (pid == 0) {
+        // the test framework catches the abort otherwise
+        std::signal(SIGABRT, SIG_DFL);
+        ::close(report[0]);
+        contract::set_crash_fd(report[1]);
+        crashing::withdraw(10, 5);
+        crashing::withdraw(10, 50);
+        ::_exit(0);
+    }
+
+    ::close(report[1]);
+    std::string const output = read_all(report[0]);
+    ::close(report[0]);
+
+    int status = 0;
+    BOOST_REQUIRE(::waitpid(pid, &status, 0) == pid);
+
+    // expect the child to report the violation and abort
+    BOOST_CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT);
+    BOOST_CHECK(output.find("message:   insufficient funds\n") != std::string::npos);
+    BOOST_CHECK(output.find("lhs:       50\nrhs:       10\n") != std::string::npos);
+}
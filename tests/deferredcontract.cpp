@@ -0,0 +1,119 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <contract/contract.hpp>
+#include <contract/deferred.hpp>
+
+#include "contract_error.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::atomic<int> deferred_checks{0};
+std::atomic<bool> checked_off_thread{false};
+std::thread::id caller_thread;
+
+bool record_check() {
+    ++deferred_checks;
+    if (std::this_thread::get_id() != caller_thread)
+        checked_off_thread = true;
+    return true;
+}
+
+class order_book
+{
+public:
+    order_book()
+    {
+        CONTRACT(ctor) {};
+    }
+
+    order_book(order_book const & other)
+        : levels_(other.levels_)
+    {
+        CONTRACT(ctor) {};
+    }
+
+    ~order_book()
+    {
+        CONTRACT(dtor) {};
+    }
+
+    void add(int qty)
+    {
+        CONTRACT(mfun) {};
+        levels_.push_back(qty);
+    }
+
+private:
+    CONTRACT(class, deferred)
+    {
+        INVARIANT(record_check());
+        for (int qty: levels_)
+            INVARIANT(qty > 0, "level {} not positive", qty);
+    };
+
+    std::vector<int> levels_;
+};
+
+} // anon namespace
+
+BOOST_AUTO_TEST_CASE(deferred_invariant_off_thread) {
+    test::contract_handler_frame cframe;
+    caller_thread = std::this_thread::get_id();
+    deferred_checks = 0;
+
+    {
+        order_book book;
+        book.add(1);
+        book.add(2);
+    }
+
+    BOOST_CHECK_NO_THROW(contract::wait_deferred_checks());
+
+    // constructor exit and two method exits; snapshots don't check themselves
+    BOOST_CHECK_EQUAL(deferred_checks.load(), 3);
+    BOOST_CHECK(checked_off_thread.load());
+}
+
+BOOST_AUTO_TEST_CASE(deferred_invariant_violation) {
+    test::contract_handler_frame cframe;
+
+    order_book book;
+
+    // expect violation to be reported asynchronously
+    BOOST_CHECK_NO_THROW(book.add(-1));
+    BOOST_CHECK_THROW(contract::wait_deferred_checks(), test::contract_error);
+
+    // expect the error to be reported once
+    BOOST_CHECK_NO_THROW(contract::wait_deferred_checks());
+}
+
+BOOST_AUTO_TEST_CASE(deferred_violation_message) {
+    test::contract_handler_frame cframe;
+
+    std::string message;
+    try {
+        order_book book;
+        book.add(-1);
+        contract::wait_deferred_checks();
+    } catch (test::contract_error const & e) {
+        // the message outlives the next message formatted by the verifier
+        order_book other;
+        other.add(-2);
+        BOOST_CHECK_THROW(contract::wait_deferred_checks(), test::contract_error);
+        message = e.message();
+    }
+
+    BOOST_CHECK_EQUAL(message, "level -1 not positive");
+}
@@ -146,6 +146,82 @@ private:
     };
 };
 
+
+int shared_checks = 0;
+int left_checks = 0;
+int right_checks = 0;
+
+class shared_base
+{
+public:
+    int value = 1;
+
+private:
+    CONTRACT(class)
+    {
+        INVARIANT(++shared_checks && value > 0);
+    };
+};
+
+class left_base : public virtual shared_base
+{
+private:
+    CONTRACT(derived)(shared_base)
+    {
+        INVARIANT(++left_checks);
+    };
+};
+
+class right_base : public virtual shared_base
+{
+private:
+    CONTRACT(derived)(shared_base)
+    {
+        INVARIANT(++right_checks);
+    };
+};
+
+// Diamond hierarchy naming the shared base again.
+class diamond : public left_base
+              , public right_base
+{
+public:
+    void set(int v)
+    {
+        CONTRACT(mfun) {};
+        value = v;
+    }
+
+private:
+    CONTRACT(derived)(left_base, right_base, shared_base)
+    {
+        INVARIANT(true);
+    };
+};
+
+// Deep hierarchy: the invariant of `shared_base` is enforced through
+// `left_base`.
+class deep : public left_base
+{
+public:
+    void set(int v)
+    {
+        CONTRACT(mfun) {};
+        value = v;
+    }
+
+private:
+    CONTRACT(derived)(left_base)
+    {
+        INVARIANT(true);
+    };
+};
+
+void reset_checks()
+{
+    shared_checks = left_checks = right_checks = 0;
+}
+
 } // anon namespace
 
 BOOST_AUTO_TEST_CASE(derived_contract_with_many_bases) {
@@ -201,3 +277,32 @@ BOOST_AUTO_TEST_CASE(derived_contract_in_method) {
 
     BOOST_CHECK(caught_exception);
 }
+
+BOOST_AUTO_TEST_CASE(derived_contract_diamond) {
+    test::contract_handler_frame cframe;
+
+    diamond d;
+    reset_checks();
+
+    // expect every base invariant to be checked once on entry and once on exit
+    BOOST_CHECK_NO_THROW(d.set(2));
+    BOOST_CHECK_EQUAL(shared_checks, 2);
+    BOOST_CHECK_EQUAL(left_checks, 2);
+    BOOST_CHECK_EQUAL(right_checks, 2);
+
+    BOOST_CHECK_THROW(d.set(0), test::contract_error);
+}
+
+BOOST_AUTO_TEST_CASE(derived_contract_deep) {
+    test::contract_handler_frame cframe;
+
+    deep d;
+    reset_checks();
+
+    BOOST_CHECK_NO_THROW(d.set(2));
+    BOOST_CHECK_EQUAL(shared_checks, 2);
+    BOOST_CHECK_EQUAL(left_checks, 2);
+
+    // expect the invariant of the indirect base to be enforced
+    BOOST_CHECK_THROW(d.set(0), test::contract_error);
+}
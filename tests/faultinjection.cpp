@@ -0,0 +1,121 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#define CONTRACT_FAULT_INJECTION
+#include <contract/contract.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+namespace {
+
+namespace observed {
+
+// Observe-mode policy: counts the reported violations and continues.
+struct observe_policy: contract::default_policy {
+    static void handle(contract::violation_context const & context) noexcept {
+        ++violations[static_cast<int>(context.contract_type)];
+    }
+
+    static int violations[3];
+
+    static void reset() {
+        violations[0] = violations[1] = violations[2] = 0;
+    }
+};
+
+int observe_policy::violations[3];
+
+CONTRACT_POLICY(observe_policy);
+
+int evaluated = 0;
+
+void transfer(int amount) {
+    CONTRACT(fun) {
+        PRECONDITION(++evaluated && amount > 0);
+        POSTCONDITION_GE(amount, 0);
+    };
+}
+
+} // namespace observed
+
+using observed::observe_policy;
+
+struct fault_frame {
+    fault_frame() {
+        contract::clear_faults();
+        observe_policy::reset();
+        observed::evaluated = 0;
+    }
+
+    ~fault_frame() { contract::clear_faults(); }
+};
+
+int const pre = static_cast<int>(contract::type::precondition);
+int const post = static_cast<int>(contract::type::postcondition);
+
+} // anon namespace
+
+BOOST_AUTO_TEST_CASE(fault_injection_off) {
+    fault_frame frame;
+
+    observed::transfer(10);
+    BOOST_CHECK_EQUAL(observe_policy::violations[pre], 0);
+    BOOST_CHECK_EQUAL(observe_policy::violations[post], 0);
+}
+
+BOOST_AUTO_TEST_CASE(fault_injection_by_type) {
+    fault_frame frame;
+    std::uint64_t const injected = contract::injected_faults();
+
+    BOOST_REQUIRE(contract::inject_faults(contract::fault_rule::of_type(contract::type::postcondition)));
+    observed::transfer(10);
+    observed::transfer(10);
+
+    // expect the condition to be evaluated and only postconditions to fail
+    BOOST_CHECK_EQUAL(observed::evaluated, 2);
+    BOOST_CHECK_EQUAL(observe_policy::violations[pre], 0);
+    BOOST_CHECK_EQUAL(observe_policy::violations[post], 2);
+    BOOST_CHECK_EQUAL(contract::injected_faults() - injected, 2u);
+}
+
+BOOST_AUTO_TEST_CASE(fault_injection_by_location) {
+    fault_frame frame;
+
+    BOOST_REQUIRE(contract::inject_faults(contract::fault_rule::at("faultinjection.cpp", 40)));
+    BOOST_REQUIRE(contract::inject_faults(contract::fault_rule::at("other.cpp")));
+    observed::transfer(10);
+    BOOST_CHECK_EQUAL(observe_policy::violations[pre], 1);
+    BOOST_CHECK_EQUAL(observe_policy::violations[post], 0);
+}
+
+BOOST_AUTO_TEST_CASE(fault_injection_probability) {
+    fault_frame frame;
+
+    BOOST_REQUIRE(contract::inject_faults(
+        contract::fault_rule::everywhere().only(contract::type::precondition).probability(0.25)));
+    for (int i = 0; i != 10000; ++i)
+        observed::transfer(10);
+
+    BOOST_CHECK(observe_policy::violations[pre] > 2000);
+    BOOST_CHECK(observe_policy::violations[pre] < 3000);
+    BOOST_CHECK_EQUAL(observe_policy::violations[post], 0);
+}
+
+BOOST_AUTO_TEST_CASE(fault_injection_spec) {
+    fault_frame frame;
+
+    char spec[] = "postcondition@0,faultinjection.cpp:40@1";
+    BOOST_REQUIRE(contract::inject_faults(spec));
+    observed::transfer(10);
+    BOOST_CHECK_EQUAL(observe_policy::violations[pre], 1);
+    BOOST_CHECK_EQUAL(observe_policy::violations[post], 0);
+
+    char bad[] = "file.cpp:x";
+    BOOST_CHECK(!contract::inject_faults(bad));
+}
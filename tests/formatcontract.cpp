@@ -0,0 +1,98 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <contract/contract.hpp>
+
+#include "contract_error.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+namespace {
+
+// number of evaluated message arguments
+int formatted = 0;
+
+std::string name_of(int id) {
+    ++formatted;
+    return id == 0 ? "zero" : "other";
+}
+
+int at(int const * values, int i, int n) {
+    CONTRACT(fun) {
+        PRECONDITION(i >= 0 && i < n, "index {} out of range [0,{})", i, n);
+    };
+    return values[i];
+}
+
+void rename_user(int id, std::string const & name) {
+    CONTRACT(fun) {
+        PRECONDITION(!name.empty(), "empty name for {} ({}) {{{}}}", id, name_of(id), 'x');
+    };
+}
+
+void many(int a, double b, bool c, char const * d, unsigned e, long f) {
+    CONTRACT(fun) {
+        PRECONDITION_LT(a, 0, "{} {} {} {} {} {}", a, b, c, d, e, f);
+    };
+}
+
+static_assert(contract::detail::message_placeholders("{} and {}") == 2, "");
+static_assert(contract::detail::message_placeholders("{{}} {}") == 1, "");
+static_assert(contract::detail::message_placeholders("none") == 0, "");
+static_assert(contract::detail::message_placeholders("{x}")
+              == contract::detail::bad_message_format, "");
+static_assert(contract::detail::message_placeholders("}")
+              == contract::detail::bad_message_format, "");
+
+} // anon namespace
+
+BOOST_AUTO_TEST_CASE(format_message) {
+    test::contract_handler_frame cframe;
+
+    int const values[] = {1, 2, 3};
+    BOOST_CHECK_EQUAL(at(values, 2, 3), 3);
+
+    try {
+        at(values, 5, 3);
+        BOOST_FAIL("expected a contract violation");
+    } catch (test::contract_error & e) {
+        BOOST_CHECK_EQUAL(e.message(), "index 5 out of range [0,3)");
+        BOOST_CHECK_EQUAL(e.condition(), "i >= 0 && i < n");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(format_message_lazy) {
+    test::contract_handler_frame cframe;
+    formatted = 0;
+
+    // expect the arguments to be evaluated only on violation
+    rename_user(0, "a");
+    BOOST_CHECK_EQUAL(formatted, 0);
+
+    try {
+        rename_user(0, "");
+        BOOST_FAIL("expected a contract violation");
+    } catch (test::contract_error & e) {
+        BOOST_CHECK_EQUAL(e.message(), "empty name for 0 (zero) {x}");
+    }
+    BOOST_CHECK_EQUAL(formatted, 1);
+}
+
+BOOST_AUTO_TEST_CASE(format_message_many_arguments) {
+    test::contract_handler_frame cframe;
+
+    try {
+        many(1, 2.5, true, "four", 5u, -6);
+        BOOST_FAIL("expected a contract violation");
+    } catch (test::contract_error & e) {
+        BOOST_CHECK_EQUAL(e.message(), "1 2.5 true four 5 -6");
+        BOOST_CHECK(e.context().lhs.get_kind()
+                    == contract::captured_value::kind::signed_integer);
+    }
+}
@@ -0,0 +1,73 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Built with `CONTRACT_INSTRUMENTED` (the contract::instrumented CMake target),
+// without any other setup.
+
+#include <contract/contract.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+int halve(int n) {
+    CONTRACT(fun) {
+        PRECONDITION(n % 2 == 0, "n must be even");
+    };
+
+    return n / 2;
+}
+
+class counter {
+public:
+    void add(int n) {
+        CONTRACT(mfun) {
+            PRECONDITION(n > 0);
+        };
+
+        value_ += n;
+    }
+
+private:
+    CONTRACT(class) { INVARIANT(value_ >= 0); };
+
+private:
+    int value_ = 0;
+};
+
+} // anon namespace
+
+BOOST_AUTO_TEST_CASE(instrumented_counts) {
+    halve(2);
+    halve(4);
+
+    counter c;
+    c.add(1);
+
+    std::ostringstream dump;
+    contract::dump_metrics(dump);
+
+    std::string const lines = dump.str();
+    BOOST_CHECK(lines.find(" precondition 2 0 ") != std::string::npos);
+    BOOST_CHECK(lines.find("instrumented.cpp:26 n % 2 == 0\n") != std::string::npos);
+    BOOST_CHECK(lines.find(" invariant 2 0 ") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(instrumented_segment) {
+    // expect the segment under the default name contract-top attaches to
+    std::string const name = "/contract-" + std::to_string(::getpid());
+    int const fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    BOOST_REQUIRE(fd >= 0);
+    ::close(fd);
+}
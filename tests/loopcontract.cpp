@@ -12,6 +12,8 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <cstdint>
+
 void loop_invariant_success() {
     for (int i = 0; i != 10; ++i)
     {
@@ -44,6 +46,66 @@ void ignore_pre_postcondition() {
     }
 }
 
+int deferred_sum(int const * values, std::size_t size) {
+    int sum = 0;
+
+    CONTRACT(loop, deferred)
+    {
+        for (std::size_t i = 0; i != size; ++i)
+        {
+            LOOP_INVARIANT(i, values[i] >= 0, "negative value");
+            LOOP_INVARIANT(i, values[i] < 100);
+            sum += values[i];
+        }
+    };
+
+    return sum;
+}
+
+void deferred_from(std::uint64_t first, int const * values, std::size_t size) {
+    CONTRACT(loop, deferred)
+    {
+        for (std::size_t i = 0; i != size; ++i)
+            LOOP_INVARIANT(first + i, values[i] >= 0);
+    };
+}
+
+namespace flagged {
+
+// Observe-mode policy whose deferred loop invariants only fold a failure flag.
+struct flag_policy: contract::default_policy {
+    static constexpr bool loop_iterations = false;
+
+    static void handle(contract::violation_context const & context) noexcept {
+        ++violations;
+        condition = context.condition;
+        iteration = context.iteration;
+    }
+
+    static int violations;
+    static char const * condition;
+    static std::uint64_t iteration;
+};
+
+int flag_policy::violations = 0;
+char const * flag_policy::condition = nullptr;
+std::uint64_t flag_policy::iteration = 0;
+
+CONTRACT_POLICY(flag_policy);
+
+void scale(int * values, std::size_t size) {
+    CONTRACT(loop, deferred)
+    {
+        for (std::size_t i = 0; i != size; ++i)
+        {
+            LOOP_INVARIANT(i, values[i] < 100);
+            values[i] *= 2;
+        }
+    };
+}
+
+} // namespace flagged
+
 BOOST_AUTO_TEST_CASE(loop_invariant) {
     test::contract_handler_frame cframe;
 
@@ -56,3 +118,71 @@ BOOST_AUTO_TEST_CASE(loop_invariant) {
     // skip precondition and postcondition inside loop contract
     BOOST_CHECK_NO_THROW(ignore_pre_postcondition());
 }
+
+BOOST_AUTO_TEST_CASE(deferred_loop_invariant) {
+    test::contract_handler_frame cframe;
+
+    int const good[] = {1, 2, 3, 4};
+    BOOST_CHECK_EQUAL(deferred_sum(good, 4), 10);
+
+    // expect the violation of the earliest iteration to be reported once,
+    // after the loop
+    int const bad[] = {1, 2, 300, -4, -5};
+    try {
+        deferred_sum(bad, 5);
+        BOOST_FAIL("expected a contract violation");
+    } catch (test::contract_error & e) {
+        BOOST_CHECK(e.type() == contract::type::invariant);
+        BOOST_CHECK_EQUAL(e.condition(), "values[i] < 100");
+        BOOST_CHECK_EQUAL(e.context().iteration, 2u);
+    }
+
+    int const negative[] = {1, -2, 3};
+    try {
+        deferred_sum(negative, 3);
+        BOOST_FAIL("expected a contract violation");
+    } catch (test::contract_error & e) {
+        BOOST_CHECK_EQUAL(e.message(), "negative value");
+        BOOST_CHECK_EQUAL(e.context().iteration, 1u);
+    }
+
+    BOOST_CHECK_EQUAL(deferred_sum(bad, 0), 0);
+}
+
+BOOST_AUTO_TEST_CASE(deferred_loop_invariant_long_loop) {
+    test::contract_handler_frame cframe;
+
+    // expect iterations past 2^31 to be reported modulo 2^31, and a failure on
+    // the last iteration below to be reported as well
+    int const values[] = {1, -2, 3, -4};
+    try {
+        deferred_from((std::uint64_t{1} << 31) + 5, values, 4);
+        BOOST_FAIL("expected a contract violation");
+    } catch (test::contract_error & e) {
+        BOOST_CHECK_EQUAL(e.context().iteration, 6u);
+    }
+
+    int const last[] = {1, -2};
+    try {
+        deferred_from((std::uint64_t{1} << 31) - 2, last, 2);
+        BOOST_FAIL("expected a contract violation");
+    } catch (test::contract_error & e) {
+        BOOST_CHECK_EQUAL(e.context().iteration, (std::uint64_t{1} << 31) - 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(deferred_loop_invariant_flag) {
+    using flagged::flag_policy;
+
+    int good[] = {1, 2, 3};
+    flagged::scale(good, 3);
+    BOOST_CHECK_EQUAL(flag_policy::violations, 0);
+
+    // expect a single violation without the iteration
+    int bad[] = {1, 200, 300};
+    flagged::scale(bad, 3);
+    BOOST_CHECK_EQUAL(flag_policy::violations, 1);
+    BOOST_CHECK_EQUAL(flag_policy::condition, "values[i] < 100");
+    BOOST_CHECK_EQUAL(flag_policy::iteration, contract::violation_context::no_iteration);
+    BOOST_CHECK_EQUAL(bad[2], 600);
+}
@@ -0,0 +1,84 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <contract/contract.hpp>
+#include <contract/metrics.hpp>
+
+#include "contract_error.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+namespace metered {
+
+CONTRACT_POLICY(::contract::metrics_policy);
+
+int halve(int n) {
+    CONTRACT(fun) {
+        PRECONDITION(n % 2 == 0, "n must be even");
+    };
+
+    return n / 2;
+}
+
+} // namespace metered
+
+std::string const segment = "/contract-test-" + std::to_string(::getpid());
+
+} // anon namespace
+
+BOOST_AUTO_TEST_CASE(metrics_counters) {
+    test::contract_handler_frame cframe;
+    BOOST_REQUIRE(contract::open_metrics(segment.c_str()));
+
+    metered::halve(2);
+    metered::halve(4);
+    test::check_throw_on_contract_violation(
+        []{ metered::halve(3); },
+        contract::type::precondition,
+        "n must be even");
+
+    std::ostringstream dump;
+    contract::dump_metrics(dump);
+
+    std::string const line = dump.str();
+    BOOST_CHECK(line.find(" precondition 3 1 ") != std::string::npos);
+    BOOST_CHECK(line.find("metricscontract.cpp:30 n % 2 == 0\n") != std::string::npos);
+
+    // expect another process to see the counters through the segment
+    int const fd = ::shm_open(segment.c_str(), O_RDONLY, 0);
+    BOOST_REQUIRE(fd >= 0);
+    std::size_t const size = sizeof(contract::metrics_header) + sizeof(contract::metrics_site);
+    void * map = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    BOOST_REQUIRE(map != MAP_FAILED);
+
+    auto const * header = static_cast<contract::metrics_header const *>(map);
+    auto const * site = reinterpret_cast<contract::metrics_site const *>(header + 1);
+    BOOST_CHECK_EQUAL(header->magic, contract::metrics_header::magic_value);
+    BOOST_CHECK_EQUAL(header->pid, static_cast<std::uint64_t>(::getpid()));
+    BOOST_CHECK_EQUAL(header->used, 1u);
+    BOOST_CHECK_NE(site->site, 0u);
+    BOOST_CHECK_EQUAL(site->evaluations, 3u);
+    BOOST_CHECK_EQUAL(site->violations, 1u);
+    BOOST_CHECK_EQUAL(site->line, 30u);
+    BOOST_CHECK_EQUAL(std::string(site->condition), "n % 2 == 0");
+    ::munmap(map, size);
+
+    // expect the segment to be removed on close and nothing counted after
+    contract::close_metrics();
+    BOOST_CHECK(::shm_open(segment.c_str(), O_RDONLY, 0) < 0);
+    BOOST_CHECK_NO_THROW(metered::halve(2));
+}
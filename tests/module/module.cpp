@@ -0,0 +1,115 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Uses the library through `import contract;`, so without Boost.Test; exits
+// with the number of failed checks.
+
+#include <cstdio>
+
+import contract;
+
+#include <contract/macros.hpp>
+
+namespace {
+
+int failures = 0;
+
+#define MODULE_CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("%s:%d: check %s failed\n", __FILE__, __LINE__, #cond); \
+            ++failures; \
+        } \
+    } while (false)
+
+namespace observed {
+
+// Observe-mode policy: counts the reported violations and continues.
+struct observe_policy: contract::default_policy {
+    static void handle(contract::violation_context const & context) noexcept {
+        ++violations;
+        last_site = context.site;
+    }
+
+    static int violations;
+    static unsigned long long last_site;
+};
+
+int observe_policy::violations = 0;
+unsigned long long observe_policy::last_site = 0;
+
+CONTRACT_POLICY(observe_policy);
+
+class account {
+public:
+    explicit account(int balance)
+        : balance_{balance}
+    {
+        CONTRACT(ctor) {
+            PRECONDITION(balance >= 0);
+        };
+    }
+
+    void withdraw(int amount) {
+        CONTRACT(mfun) {
+            PRECONDITION_GT(amount, 0, "amount {} is not positive", amount);
+            POSTCONDITION(balance_ >= 0);
+        };
+
+        balance_ -= amount;
+    }
+
+private:
+    CONTRACT(class) { INVARIANT(balance_ >= 0); };
+
+private:
+    int balance_;
+};
+
+int sum(int const * values, int size) {
+    int total = 0;
+
+    CONTRACT(loop, deferred) {
+        for (int i = 0; i != size; ++i) {
+            LOOP_INVARIANT(i, values[i] >= 0);
+            total += values[i];
+        }
+    }
+
+    return total;
+}
+
+} // namespace observed
+
+} // anon namespace
+
+int main() {
+    using observed::observe_policy;
+
+    observed::account a{10};
+    a.withdraw(5);
+    MODULE_CHECK(observe_policy::violations == 0);
+
+    // expect the precondition, then the postcondition and invariant to fail
+    a.withdraw(-1);
+    MODULE_CHECK(observe_policy::violations == 1);
+    MODULE_CHECK(observe_policy::last_site != 0);
+    a.withdraw(20);
+    MODULE_CHECK(observe_policy::violations == 3);
+
+    {
+        contract::suppress_scope suppress;
+        a.withdraw(1);
+        MODULE_CHECK(observe_policy::violations == 3);
+    }
+
+    int const values[] = {1, 2, -3, 4};
+    MODULE_CHECK(observed::sum(values, 4) == 4);
+    MODULE_CHECK(observe_policy::violations == 4);
+
+    return failures;
+}
@@ -0,0 +1,63 @@
+# Copyright Alexei Zakharov, 2013.
+# Copyright niXman (i dot nixman dog gmail dot com) 2016.
+#
+# Distributed under the Boost Software License, Version 1.0.
+# (See accompanying file LICENSE_1_0.txt or copy at
+# http://www.boost.org/LICENSE_1_0.txt)
+
+# Check that every holder of thread-local state in the module interface is
+# defined by the module only.
+#
+# usage: cmake -DHEADER=<contract.hpp> -DINTERFACE=<contract.cppm>
+#              -P thread_local.cmake
+#
+# GCC 12 gives translation units that import the module a wrong TLS model for
+# the thread-local variables the module instantiates, so each
+# `struct <name>_holder` of HEADER with a `thread_local` variable needs an
+# `extern template struct <name>_holder<void>;` in HEADER and an explicit
+# instantiation in INTERFACE.
+
+cmake_minimum_required(VERSION 3.16)
+
+file(READ ${HEADER} header)
+file(READ ${INTERFACE} interface)
+
+# semicolons would split the matches into list elements
+string(REPLACE ";" "," header "${header}")
+string(REPLACE ";" "," interface "${interface}")
+
+set(checked 0)
+string(REGEX MATCHALL "struct [a-z_]+_holder {" holders "${header}")
+foreach(holder IN LISTS holders)
+    # the holder runs to the first `};` in column 0
+    string(FIND "${header}" "${holder}" begin)
+    string(SUBSTRING "${header}" ${begin} -1 body)
+    string(FIND "${body}" "\n};" end)
+    string(SUBSTRING "${body}" 0 ${end} body)
+    if(NOT body MATCHES "thread_local")
+        continue()
+    endif()
+
+    string(REGEX MATCH "^struct ([a-z_]+_holder)" name "${holder}")
+    set(name ${CMAKE_MATCH_1})
+    math(EXPR checked "${checked} + 1")
+
+    string(FIND "${header}" "extern template struct ${name}<void>," declared)
+    if(declared EQUAL -1)
+        message(SEND_ERROR "${HEADER}: ${name} has thread-local state but no "
+                           "`extern template struct ${name}<void>;`")
+    endif()
+
+    string(FIND "${interface}" "template struct contract::detail::${name}<void>," defined)
+    if(defined EQUAL -1)
+        message(SEND_ERROR "${INTERFACE}: ${name} has thread-local state but is not "
+                           "instantiated by the module")
+    endif()
+endforeach()
+
+# the holders are found by their layout, so expect to find some
+if(checked EQUAL 0)
+    message(FATAL_ERROR "${HEADER}: no holder with thread-local state found")
+endif()
+
+message(STATUS "${checked} holders with thread-local state defined by the module")
@@ -0,0 +1,85 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <contract/contract.hpp>
+
+#include "contract_error.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <type_traits>
+
+// Lean module: preconditions only.
+namespace net {
+
+CONTRACT_MODULE(net, contract::check_policy<true, false, false>);
+
+inline
+void send(int size) {
+    CONTRACT(fun)
+    {
+        PRECONDITION(size > 0);
+        POSTCONDITION(false);
+        INVARIANT(false);
+    };
+}
+
+namespace detail {
+
+// nested namespaces belong to the enclosing module
+inline
+void validate(bool inv) {
+    CONTRACT(fun) { INVARIANT(inv); };
+}
+
+} // namespace detail
+
+} // namespace net
+
+// Fully checked module.
+namespace business {
+
+CONTRACT_MODULE(business);
+
+inline
+void order(int qty, bool post) {
+    CONTRACT(fun)
+    {
+        PRECONDITION(qty > 0);
+        POSTCONDITION(post);
+    };
+}
+
+} // namespace business
+
+static_assert(!std::is_same<net::contract_policy__, business::contract_policy__>::value,
+              "modules must have distinct contract policies");
+
+BOOST_AUTO_TEST_CASE(module_lean) {
+    test::contract_handler_frame cframe;
+
+    // expect precondition to fail
+    BOOST_CHECK_NO_THROW(net::send(1));
+    BOOST_CHECK_THROW(net::send(0), test::contract_error);
+
+    // expect invariant to be compiled out in a nested namespace
+    BOOST_CHECK_NO_THROW(net::detail::validate(false));
+}
+
+BOOST_AUTO_TEST_CASE(module_checked) {
+    test::contract_handler_frame cframe;
+
+    BOOST_CHECK_NO_THROW(business::order(1, true));
+
+    test::check_throw_on_contract_violation(
+        []{ business::order(0, true); },
+        contract::type::precondition);
+
+    test::check_throw_on_contract_violation(
+        []{ business::order(1, false); },
+        contract::type::postcondition);
+}
@@ -0,0 +1,102 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Built with -fno-exceptions, so without Boost.Test; exits with the number of
+// failed checks.
+
+#include <contract/contract.hpp>
+#include <contract/deferred.hpp>
+#include <contract/parallel.hpp>
+
+#include <cstdio>
+#include <type_traits>
+#include <vector>
+
+#if !defined(CONTRACT_NO_EXCEPTIONS)
+#	error "expected CONTRACT_NO_EXCEPTIONS with exceptions disabled"
+#endif
+
+namespace {
+
+int failures = 0;
+
+#define NOEXCEPTIONS_CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("%s:%d: check %s failed\n", __FILE__, __LINE__, #cond); \
+            ++failures; \
+        } \
+    } while (false)
+
+namespace observed {
+
+// Observe-mode policy: counts the reported violations and continues.
+struct observe_policy: contract::default_policy {
+    static void handle(contract::violation_context const &) noexcept {
+        ++violations;
+    }
+
+    static int violations;
+};
+
+int observe_policy::violations = 0;
+
+CONTRACT_POLICY(observe_policy);
+
+class account {
+public:
+    explicit account(int balance)
+        : balance_{balance}
+    {}
+
+    account(account && other) CONTRACT_NOEXCEPT
+        : balance_{other.balance_}
+    {
+        CONTRACT(ctor) {};
+    }
+
+    void withdraw(int amount) {
+        CONTRACT(mfun) {
+            PRECONDITION(amount > 0);
+            POSTCONDITION(balance_ >= 0);
+        };
+
+        balance_ -= amount;
+    }
+
+private:
+    CONTRACT(class) { INVARIANT(balance_ >= 0); };
+
+private:
+    int balance_;
+};
+
+} // namespace observed
+
+} // anon namespace
+
+int main() {
+    NOEXCEPTIONS_CHECK(contract::default_policy::nothrow);
+    NOEXCEPTIONS_CHECK(std::is_nothrow_move_constructible<observed::account>::value);
+
+    observed::account a{10};
+    a.withdraw(5);
+    NOEXCEPTIONS_CHECK(observed::observe_policy::violations == 0);
+
+    // expect the precondition, then the postcondition and invariant to fail
+    a.withdraw(-1);
+    NOEXCEPTIONS_CHECK(observed::observe_policy::violations == 1);
+    a.withdraw(20);
+    NOEXCEPTIONS_CHECK(observed::observe_policy::violations == 3);
+
+    std::vector<observed::account> accounts;
+    for (int i = 0; i != 10; ++i)
+        accounts.emplace_back(i);
+    NOEXCEPTIONS_CHECK(accounts.size() == 10u);
+
+    return failures;
+}
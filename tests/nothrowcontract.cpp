@@ -0,0 +1,126 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <contract/contract.hpp>
+
+#include "contract_error.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+int copies = 0;
+int moves = 0;
+
+// A type with a checked move constructor that is `noexcept` exactly when its
+// contract policy is `nothrow`.
+#define NOTHROW_TEST_BUFFER \
+    class buffer { \
+    public: \
+        explicit buffer(int size) \
+            : size_{size} \
+        {} \
+        \
+        buffer(buffer const & other) \
+            : size_{other.size_} \
+        { \
+            ++copies; \
+        } \
+        \
+        buffer(buffer && other) CONTRACT_NOEXCEPT \
+            : size_{other.size_} \
+        { \
+            CONTRACT(ctor) { POSTCONDITION(size_ >= 0); }; \
+            ++moves; \
+        } \
+        \
+        int size() const { return size_; } \
+        \
+    private: \
+        CONTRACT(class) { INVARIANT(size_ >= 0); }; \
+        \
+    private: \
+        int size_; \
+    };
+
+namespace checked {
+
+NOTHROW_TEST_BUFFER
+
+} // namespace checked
+
+namespace nothrow {
+
+CONTRACT_POLICY(::contract::nothrow_policy<>);
+
+NOTHROW_TEST_BUFFER
+
+void withdraw(int balance, int amount) {
+    CONTRACT(fun) { PRECONDITION(amount <= balance); };
+}
+
+} // namespace nothrow
+
+template <typename Buffer>
+void grow(int count) {
+    copies = moves = 0;
+    std::vector<Buffer> buffers;
+    for (int i = 0; i != count; ++i)
+        buffers.emplace_back(i);
+}
+
+} // anon namespace
+
+BOOST_AUTO_TEST_CASE(nothrow_contract_scopes) {
+    using checked_scope = contract::detail::fun_contract<contract::default_policy, void (*)()>;
+    using nothrow_scope = contract::detail::fun_contract<contract::nothrow_policy<>, void (*)()>;
+
+    BOOST_CHECK(!std::is_nothrow_destructible<checked_scope>::value);
+    BOOST_CHECK(std::is_nothrow_destructible<nothrow_scope>::value);
+    BOOST_CHECK(!std::is_nothrow_move_constructible<checked::buffer>::value);
+    BOOST_CHECK(std::is_nothrow_move_constructible<nothrow::buffer>::value);
+}
+
+BOOST_AUTO_TEST_CASE(nothrow_vector_growth) {
+    test::contract_handler_frame cframe;
+
+    // expect reallocation to copy buffers whose checked move may throw
+    grow<checked::buffer>(100);
+    BOOST_CHECK(copies > 0);
+
+    // and to move the others
+    grow<nothrow::buffer>(100);
+    BOOST_CHECK_EQUAL(copies, 0);
+    BOOST_CHECK(moves > 0);
+}
+
+BOOST_AUTO_TEST_CASE(nothrow_handler_exception_terminates) {
+    ::pid_t const pid = ::fork();
+    BOOST_REQUIRE(pid >= 0);
+
+    if (pid == 0) {
+        contract::set_handler(test::throw_contract_error);
+        std::set_terminate([] { ::_exit(3); });
+        nothrow::withdraw(10, 5);
+        nothrow::withdraw(10, 50);
+        ::_exit(0);
+    }
+
+    int status = 0;
+    BOOST_REQUIRE(::waitpid(pid, &status, 0) == pid);
+
+    // expect the exception thrown by the handler not to leave the contract
+    BOOST_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 3);
+}
@@ -0,0 +1,230 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <contract/contract.hpp>
+#include <contract/parallel.hpp>
+
+#include "contract_error.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+std::atomic<int> parallel_checks{0};
+
+bool record_check() {
+    ++parallel_checks;
+    return true;
+}
+
+class price_index
+{
+private:
+    CONTRACT(class)
+    {
+        INVARIANT(record_check());
+        INVARIANT(prices_ >= 0);
+    };
+
+protected:
+    int prices_ = 0;
+};
+
+class volume_index
+{
+private:
+    CONTRACT(class)
+    {
+        INVARIANT(record_check());
+        INVARIANT(volumes_ >= 0);
+    };
+
+protected:
+    int volumes_ = 0;
+};
+
+class no_index {};
+
+class market_index : public price_index
+                   , public volume_index
+                   , public no_index
+{
+public:
+    market_index()
+    {
+        CONTRACT(ctor) {};
+    }
+
+    void update(int prices, int volumes, int orders)
+    {
+        CONTRACT(mfun) {};
+        prices_ = prices;
+        volumes_ = volumes;
+        orders_ = orders;
+    }
+
+private:
+    CONTRACT(derived, parallel)(price_index, volume_index, no_index)
+    {
+        INVARIANT(record_check());
+        INVARIANT(orders_ >= 0);
+    };
+
+    int orders_ = 0;
+};
+
+std::thread::id calling_thread;
+std::atomic<bool> off_thread{false};
+
+bool record_thread() {
+    if (std::this_thread::get_id() != calling_thread)
+        off_thread = true;
+    return true;
+}
+
+// Wait a while for a check to run off the calling thread, so the test doesn't
+// depend on which tasks the waiting calling thread picks up itself: the
+// first check it runs holds it until a worker has run another one.
+bool await_thread() {
+    record_thread();
+
+    auto const stop = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!off_thread && std::chrono::steady_clock::now() < stop)
+        std::this_thread::yield();
+    return true;
+}
+
+class waiting_base
+{
+private:
+    CONTRACT(class) { INVARIANT(await_thread()); };
+};
+
+class other_waiting_base
+{
+private:
+    CONTRACT(class) { INVARIANT(await_thread()); };
+};
+
+class threaded_index : public waiting_base
+                     , public other_waiting_base
+{
+public:
+    threaded_index()
+    {
+        CONTRACT(ctor) {};
+    }
+
+private:
+    CONTRACT(derived, parallel)(waiting_base, other_waiting_base)
+    {
+        INVARIANT(await_thread());
+    };
+};
+
+std::atomic<int> running_checks{0};
+std::atomic<bool> concurrent{false};
+
+// Wait a while for the other check of the block to run at the same time.
+bool await_other() {
+    ++running_checks;
+
+    auto const stop = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (running_checks < 2 && std::chrono::steady_clock::now() < stop)
+        std::this_thread::yield();
+    if (running_checks >= 2)
+        concurrent = true;
+    return true;
+}
+
+class order_index
+{
+public:
+    order_index()
+    {
+        CONTRACT(ctor) {};
+    }
+
+    void update(int volume)
+    {
+        CONTRACT(mfun) {};
+        volumes_[volume & 7] = volume;
+    }
+
+private:
+    CONTRACT(class, parallel)
+    {
+        INVARIANT(await_other());
+        INVARIANT(await_other());
+        for (int volume: volumes_)
+            INVARIANT(record_check() && volume >= 0);
+    };
+
+    int volumes_[8] = {};
+};
+
+} // anon namespace
+
+BOOST_AUTO_TEST_CASE(parallel_invariants) {
+    test::contract_handler_frame cframe;
+    parallel_checks = 0;
+
+    market_index index;
+    BOOST_CHECK_EQUAL(parallel_checks.load(), 3);
+
+    // expect every invariant to be checked on entry and exit
+    BOOST_CHECK_NO_THROW(index.update(1, 2, 3));
+    BOOST_CHECK_EQUAL(parallel_checks.load(), 9);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_invariant_violation) {
+    test::contract_handler_frame cframe;
+
+    market_index index;
+
+    // expect violations of base and derived invariants on the calling thread
+    test::check_throw_on_contract_violation(
+        [&]{ index.update(1, -1, 1); },
+        contract::type::invariant);
+
+    market_index other;
+    test::check_throw_on_contract_violation(
+        [&]{ other.update(1, 1, -1); },
+        contract::type::invariant);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_invariants_off_thread) {
+    test::contract_handler_frame cframe;
+    calling_thread = std::this_thread::get_id();
+    off_thread = false;
+
+    // expect some invariant block to be checked on a worker thread
+    threaded_index index;
+    BOOST_CHECK(off_thread.load());
+}
+
+BOOST_AUTO_TEST_CASE(parallel_checks_of_one_block) {
+    test::contract_handler_frame cframe;
+    running_checks = 0;
+    concurrent = false;
+    parallel_checks = 0;
+
+    // expect the checks of a single block to be checked at the same time,
+    // each of them once
+    order_index index;
+    BOOST_CHECK(concurrent.load());
+    BOOST_CHECK_EQUAL(running_checks.load(), 2);
+    BOOST_CHECK_EQUAL(parallel_checks.load(), 8);
+
+    test::check_throw_on_contract_violation(
+        [&]{ index.update(-3); },
+        contract::type::invariant);
+}
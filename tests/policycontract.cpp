@@ -0,0 +1,174 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <contract/contract.hpp>
+
+#include "contract_error.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+namespace {
+
+// Policy that counts evaluated checks and throws on violations without going
+// through the global handler.
+struct counting_policy: contract::default_policy {
+    static void count(contract::type) noexcept { ++checks; }
+
+    static void handle(contract::violation_context const & context) {
+        throw test::contract_error(context);
+    }
+
+    static int checks;
+};
+
+int counting_policy::checks = 0;
+
+// Policy that evaluates every other contract block.
+struct sampling_policy: counting_policy {
+    static bool sample() noexcept { return (++calls & 1) != 0; }
+
+    static int calls;
+};
+
+int sampling_policy::calls = 0;
+
+// Policy with invariants compiled out.
+struct no_invariants_policy: counting_policy {
+    static constexpr bool invariants = false;
+};
+
+namespace checked {
+
+CONTRACT_POLICY(counting_policy);
+
+void precondition(bool pre) {
+    CONTRACT(fun) { PRECONDITION(pre); };
+}
+
+void all(bool pre, bool inv, bool post) {
+    CONTRACT(fun)
+    {
+        PRECONDITION(pre);
+        INVARIANT(inv);
+        POSTCONDITION(post);
+    };
+}
+
+} // namespace checked
+
+namespace unchecked {
+
+CONTRACT_POLICY(contract::unchecked_policy);
+
+void all(bool pre, bool inv, bool post) {
+    CONTRACT(fun)
+    {
+        PRECONDITION(pre);
+        INVARIANT(inv);
+        POSTCONDITION(post);
+    };
+}
+
+} // namespace unchecked
+
+namespace sampled {
+
+CONTRACT_POLICY(sampling_policy);
+
+void precondition(bool pre) {
+    CONTRACT(fun) { PRECONDITION(pre); };
+}
+
+} // namespace sampled
+
+// Class selecting its own policy.
+class account {
+    CONTRACT_POLICY(no_invariants_policy);
+
+public:
+    void balance(int bal) {
+        CONTRACT(mfun) { PRECONDITION(bal >= 0); };
+        balance_ = bal;
+    }
+
+private:
+    CONTRACT(class) { INVARIANT(balance_ > 0); };
+
+    int balance_ = 1;
+};
+
+// Class template that can be instantiated checked and unchecked.
+template <typename Policy>
+class buffer {
+    CONTRACT_POLICY(Policy);
+
+public:
+    char at(std::size_t idx) const {
+        CONTRACT(mfun) { PRECONDITION(idx < sizeof data_); };
+        // bounds-safe: the precondition only throws in checked instantiations
+        return idx < sizeof data_ ? data_[idx] : '\0';
+    }
+
+private:
+    CONTRACT(class) { INVARIANT(data_[0] == 'a'); };
+
+    char data_[4] = {'a', 'b', 'c', 'd'};
+};
+
+} // anon namespace
+
+BOOST_AUTO_TEST_CASE(policy_namespace) {
+    counting_policy::checks = 0;
+
+    // expect policy handler to be called without the global handler
+    BOOST_CHECK_NO_THROW(checked::precondition(true));
+    BOOST_CHECK_THROW(checked::precondition(false), test::contract_error);
+    BOOST_CHECK_EQUAL(counting_policy::checks, 2);
+
+    // expect every check to be evaluated once
+    counting_policy::checks = 0;
+    BOOST_CHECK_NO_THROW(checked::all(true, true, true));
+    BOOST_CHECK_EQUAL(counting_policy::checks, 4);
+
+    test::check_throw_on_contract_violation(
+        []{ checked::all(true, true, false); },
+        contract::type::postcondition);
+
+    // expect unchecked policy to compile the checks out
+    BOOST_CHECK_NO_THROW(unchecked::all(false, false, false));
+}
+
+BOOST_AUTO_TEST_CASE(policy_sampling) {
+    sampling_policy::calls = 0;
+
+    // expect only the odd calls to be checked
+    BOOST_CHECK_THROW(sampled::precondition(false), test::contract_error);
+    BOOST_CHECK_NO_THROW(sampled::precondition(false));
+    BOOST_CHECK_THROW(sampled::precondition(false), test::contract_error);
+    BOOST_CHECK_EQUAL(sampling_policy::calls, 3);
+}
+
+BOOST_AUTO_TEST_CASE(policy_class) {
+    account acc;
+
+    // expect class invariant to be compiled out, and precondition to fail
+    BOOST_CHECK_NO_THROW(acc.balance(0));
+    BOOST_CHECK_THROW(acc.balance(-1), test::contract_error);
+}
+
+BOOST_AUTO_TEST_CASE(policy_class_template) {
+    test::contract_handler_frame cframe;
+
+    buffer<contract::default_policy> checked_buffer;
+    buffer<contract::unchecked_policy> unchecked_buffer;
+
+    BOOST_CHECK_EQUAL(checked_buffer.at(1), 'b');
+    BOOST_CHECK_THROW(checked_buffer.at(4), test::contract_error);
+
+    // expect no check in the unchecked instantiation
+    BOOST_CHECK_EQUAL(unchecked_buffer.at(3), 'd');
+}
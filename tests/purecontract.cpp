@@ -0,0 +1,67 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <contract/contract.hpp>
+#include <contract/pure.hpp>
+
+#include "contract_error.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+namespace {
+
+int schema_checks = 0;
+
+bool valid_schema(int id, std::string const & name) {
+    ++schema_checks;
+    return id > 0 && !name.empty();
+}
+
+void store(int id, std::string const & name) {
+    CONTRACT(fun) { PRECONDITION_PURE(valid_schema, id, name); };
+}
+
+void load(int id, std::string const & name) {
+    CONTRACT(fun) { PRECONDITION_PURE(valid_schema, id, name); };
+}
+
+} // anon namespace
+
+BOOST_AUTO_TEST_CASE(pure_precondition_cached) {
+    test::contract_handler_frame cframe;
+    schema_checks = 0;
+
+    // expect the predicate to be evaluated once per arguments
+    BOOST_CHECK_NO_THROW(store(1, "orders"));
+    BOOST_CHECK_NO_THROW(store(1, "orders"));
+    BOOST_CHECK_EQUAL(schema_checks, 1);
+
+    BOOST_CHECK_NO_THROW(store(2, "orders"));
+    BOOST_CHECK_NO_THROW(store(1, "trades"));
+    BOOST_CHECK_EQUAL(schema_checks, 3);
+
+    // expect each check site to have its own cache entries
+    BOOST_CHECK_NO_THROW(load(1, "orders"));
+    BOOST_CHECK_EQUAL(schema_checks, 4);
+}
+
+BOOST_AUTO_TEST_CASE(pure_precondition_failure) {
+    test::contract_handler_frame cframe;
+    schema_checks = 0;
+
+    // expect failures not to be cached
+    test::check_throw_on_contract_violation(
+        []{ store(0, "orders"); },
+        contract::type::precondition,
+        "valid_schema(id, name)");
+    test::check_throw_on_contract_violation(
+        []{ store(0, "orders"); },
+        contract::type::precondition);
+    BOOST_CHECK_EQUAL(schema_checks, 2);
+}
@@ -0,0 +1,127 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#define CONTRACT_SEMANTIC quick_enforce
+#include <contract/contract.hpp>
+#include <contract/containers.hpp>
+#include <contract/pure.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <csignal>
+#include <cstddef>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+int evaluated = 0;
+
+int withdraw(int balance, int amount) {
+    CONTRACT(fun) {
+        PRECONDITION(amount > 0, "bad amount {}", ++evaluated);
+        PRECONDITION_LE(amount, balance);
+        POSTCONDITION(balance >= 0);
+    };
+    balance -= amount;
+    return balance;
+}
+
+int sum(int const * values, std::size_t size) {
+    int total = 0;
+    CONTRACT(loop, deferred) {
+        for (std::size_t i = 0; i != size; ++i) {
+            LOOP_INVARIANT(i, values[i] >= 0);
+            total += values[i];
+        }
+    };
+    return total;
+}
+
+bool positive(int amount) {
+    return amount > 0;
+}
+
+void deposit(int amount) {
+    CONTRACT(fun) { PRECONDITION_PURE(positive, amount); };
+}
+
+void scan(std::vector<int> & v, bool touch) {
+    CONTRACT(fun) {
+        INVARIANT_UNCHANGED(v);
+    };
+
+    if (touch)
+        v[0] = -v[0];
+}
+
+// Run `f` in a child process; returns its wait status.
+template <typename F>
+int run_child(F f) {
+    ::pid_t const pid = ::fork();
+    if (pid == 0) {
+        struct ::rlimit const no_core = {0, 0};
+        ::setrlimit(RLIMIT_CORE, &no_core);
+
+        // the test framework catches the signals of the trap
+        std::signal(SIGILL, SIG_DFL);
+        std::signal(SIGTRAP, SIG_DFL);
+
+        // the handler is never called
+        contract::set_handler([](contract::violation_context const &) { ::_exit(4); });
+        f();
+        ::_exit(0);
+    }
+
+    int status = 0;
+    if (pid < 0 || ::waitpid(pid, &status, 0) != pid)
+        return -1;
+    return status;
+}
+
+} // anon namespace
+
+BOOST_AUTO_TEST_CASE(quick_enforce_pass) {
+    evaluated = 0;
+    BOOST_CHECK_EQUAL(withdraw(10, 3), 7);
+
+    int const values[] = {1, 2, 3};
+    BOOST_CHECK_EQUAL(sum(values, 3), 6);
+
+    deposit(5);
+    deposit(5);
+
+    std::vector<int> v{1, 2, 3};
+    scan(v, false);
+
+    // expect the message arguments to be left out
+    BOOST_CHECK_EQUAL(evaluated, 0);
+}
+
+BOOST_AUTO_TEST_CASE(quick_enforce_trap) {
+    int status = run_child([] { withdraw(10, -1); });
+    BOOST_CHECK(WIFSIGNALED(status));
+
+    status = run_child([] { withdraw(10, 20); });
+    BOOST_CHECK(WIFSIGNALED(status));
+
+    int const values[] = {1, -2, 3};
+    status = run_child([&] { sum(values, 3); });
+    BOOST_CHECK(WIFSIGNALED(status));
+
+    status = run_child([] { deposit(-5); });
+    BOOST_CHECK(WIFSIGNALED(status));
+
+    status = run_child([] {
+        std::vector<int> v{1, 2, 3};
+        scan(v, true);
+    });
+    BOOST_CHECK(WIFSIGNALED(status));
+}
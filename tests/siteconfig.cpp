@@ -0,0 +1,82 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// The site levels are set by "siteconfig.hpp" of this directory, which is
+// included by <contract/contract.hpp>; its site ids are those of the checks
+// of this file.
+namespace test {
+constexpr char const site_config_file[] = __FILE__;
+} // namespace test
+
+#define CONTRACT_SITE_CONFIG "../../tests/siteconfig.hpp"
+#include <contract/contract.hpp>
+#include <contract/containers.hpp>
+#include <contract/pure.hpp>
+
+#include "contract_error.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+namespace {
+
+int sampled_evaluations = 0;
+int audit_evaluations = 0;
+
+void sampled() {
+    CONTRACT(fun) { PRECONDITION(++sampled_evaluations > 0); };
+}
+
+void audited() {
+    CONTRACT(fun) { PRECONDITION(++audit_evaluations > 0); };
+}
+
+void always(int value) {
+    CONTRACT(fun) { PRECONDITION(value > 0); };
+}
+
+bool pure_audited(int) {
+    ++audit_evaluations;
+    return true;
+}
+
+void audited_pure(int value) {
+    CONTRACT(fun) { PRECONDITION_PURE(pure_audited, value); };
+}
+
+void audited_unchanged(std::vector<int> & v) {
+    CONTRACT(fun) { INVARIANT_UNCHANGED(v); };
+    v[0] = -v[0];
+}
+
+} // anon namespace
+
+BOOST_AUTO_TEST_CASE(site_config_levels) {
+    test::contract_handler_frame cframe;
+
+    // expect one evaluation in 4 of the sampled check
+    for (int i = 0; i != 16; ++i)
+        sampled();
+    BOOST_CHECK_EQUAL(sampled_evaluations, 4);
+
+    // expect the audit check to be left out without CONTRACT_AUDIT
+    for (int i = 0; i != 16; ++i)
+        audited();
+    BOOST_CHECK_EQUAL(audit_evaluations, 0);
+
+    // expect the levels to apply to memoized and unchanged checks as well
+    for (int i = 0; i != 16; ++i)
+        audited_pure(i);
+    BOOST_CHECK_EQUAL(audit_evaluations, 0);
+
+    std::vector<int> v{1, 2, 3};
+    BOOST_CHECK_NO_THROW(audited_unchanged(v));
+
+    // expect checks without a level to be always evaluated
+    BOOST_CHECK_THROW(always(0), test::contract_error);
+}
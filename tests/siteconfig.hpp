@@ -0,0 +1,29 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Site levels of the checks of siteconfig.cpp, in the form generated by
+// `contract-pgo`.
+
+namespace contract {
+
+template <>
+struct site_config<detail::site_id(test::site_config_file, 32, "++sampled_evaluations > 0")>
+    :sampled_site<4> {};
+
+template <>
+struct site_config<detail::site_id(test::site_config_file, 36, "++audit_evaluations > 0")>
+    :audit_site {};
+
+template <>
+struct site_config<detail::site_id(test::site_config_file, 49, "pure_audited(value)")>
+    :audit_site {};
+
+template <>
+struct site_config<detail::site_id(test::site_config_file, 53, "unchanged(v)")>
+    :audit_site {};
+
+} // namespace contract
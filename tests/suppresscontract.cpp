@@ -0,0 +1,163 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <contract/contract.hpp>
+#include <contract/containers.hpp>
+
+#include "contract_error.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace {
+
+int withdraw(int balance, int amount) {
+    CONTRACT(fun) {
+        PRECONDITION(amount > 0);
+        POSTCONDITION(balance >= amount);
+    };
+
+    return balance - amount;
+}
+
+class account
+{
+public:
+    void deposit(int amount)
+    {
+        CONTRACT(mfun) {};
+        balance_ += amount;
+    }
+
+private:
+    CONTRACT(class) { INVARIANT(balance_ >= 0); };
+
+    int balance_ = 0;
+};
+
+void clamp(int * values, std::size_t size) {
+    CONTRACT(loop, deferred)
+    {
+        for (std::size_t i = 0; i != size; ++i)
+        {
+            LOOP_INVARIANT(i, values[i] >= 0);
+            values[i] = values[i] > 10 ? 10 : values[i];
+        }
+    };
+}
+
+void scan(std::vector<int> & v, bool touch) {
+    CONTRACT(fun) {
+        INVARIANT_UNCHANGED(v);
+    };
+
+    if (touch)
+        v[0] = -v[0];
+}
+
+} // anon namespace
+
+BOOST_AUTO_TEST_CASE(suppress_all) {
+    test::contract_handler_frame cframe;
+
+    {
+        contract::suppress_scope quiet;
+        BOOST_CHECK(contract::suppress_scope::suppressed(contract::type::precondition));
+        BOOST_CHECK(contract::suppress_scope::suppressed(contract::type::invariant));
+
+        // expect no contract check to be evaluated
+        BOOST_CHECK_NO_THROW(withdraw(10, -1));
+        BOOST_CHECK_NO_THROW(withdraw(0, 5));
+
+        account acc;
+        BOOST_CHECK_NO_THROW(acc.deposit(-5));
+
+        int values[] = {1, -2, 30};
+        BOOST_CHECK_NO_THROW(clamp(values, 3));
+    }
+
+    // expect the checks to be evaluated again after the scope
+    BOOST_CHECK(!contract::suppress_scope::suppressed(contract::type::precondition));
+    BOOST_CHECK_THROW(withdraw(10, -1), test::contract_error);
+}
+
+BOOST_AUTO_TEST_CASE(suppress_one_type) {
+    test::contract_handler_frame cframe;
+
+    contract::suppress_scope quiet{contract::type::invariant};
+    BOOST_CHECK(!contract::suppress_scope::suppressed(contract::type::precondition));
+
+    // expect invariants to be skipped and other checks to be evaluated
+    account acc;
+    BOOST_CHECK_NO_THROW(acc.deposit(-5));
+
+    int values[] = {-1};
+    BOOST_CHECK_NO_THROW(clamp(values, 1));
+
+    BOOST_CHECK_THROW(withdraw(10, -1), test::contract_error);
+    BOOST_CHECK_THROW(withdraw(0, 5), test::contract_error);
+}
+
+BOOST_AUTO_TEST_CASE(suppress_nested) {
+    test::contract_handler_frame cframe;
+
+    {
+        contract::suppress_scope outer{contract::type::precondition};
+        {
+            contract::suppress_scope inner{contract::type::postcondition};
+            BOOST_CHECK_NO_THROW(withdraw(10, -1));
+            BOOST_CHECK_NO_THROW(withdraw(0, 5));
+        }
+
+        // expect the inner scope to restore the outer one only
+        BOOST_CHECK_NO_THROW(withdraw(10, -1));
+        BOOST_CHECK_THROW(withdraw(0, 5), test::contract_error);
+    }
+
+    BOOST_CHECK_THROW(withdraw(10, -1), test::contract_error);
+}
+
+BOOST_AUTO_TEST_CASE(suppress_current_thread) {
+    test::contract_handler_frame cframe;
+
+    contract::suppress_scope quiet;
+
+    // expect other threads to keep evaluating their checks
+    bool thrown = false;
+    std::thread other{[&thrown] {
+        try {
+            withdraw(10, -1);
+        } catch (test::contract_error &) {
+            thrown = true;
+        }
+    }};
+    other.join();
+
+    BOOST_CHECK(thrown);
+    BOOST_CHECK_NO_THROW(withdraw(10, -1));
+}
+
+BOOST_AUTO_TEST_CASE(suppress_unchanged) {
+    test::contract_handler_frame cframe;
+
+    std::vector<int> v{1, 2, 3};
+    {
+        // expect unchanged checks to snapshot with preconditions suppressed
+        contract::suppress_scope quiet{contract::type::precondition};
+        BOOST_CHECK_NO_THROW(scan(v, false));
+        BOOST_CHECK_THROW(scan(v, true), test::contract_error);
+    }
+
+    {
+        // expect no snapshot to be taken nor compared
+        contract::suppress_scope quiet{contract::type::invariant};
+        BOOST_CHECK_NO_THROW(scan(v, true));
+    }
+}
@@ -5,28 +5,52 @@ CONFIG -= app_bundle
 CONFIG -= qt
 
 QMAKE_CXXFLAGS += \
-	-std=c++11
+	-std=c++11 \
+	-pthread
 
 SOURCES += \
 	main.cpp \
+	adaptivecontract.cpp \
+	assumepreconditions.cpp \
+	binarylog.cpp \
+	budgetcontract.cpp \
 	classcontract.cpp \
+	comparecontract.cpp \
+	containercontract.cpp \
+	crashhandler.cpp \
 	ctorcontract.cpp \
+	deferredcontract.cpp \
 	derivedcontract.cpp \
 	disableinvariants.cpp \
 	disablepostconditions.cpp \
 	disablepreconditions.cpp \
 	dtorcontract.cpp \
 	examples.cpp \
+	faultinjection.cpp \
+	formatcontract.cpp \
 	funcontract.cpp \
 	loopcontract.cpp \
+	metricscontract.cpp \
 	mfuncontract.cpp \
+	modulecontract.cpp \
+	nothrowcontract.cpp \
+	parallelcontract.cpp \
+	policycontract.cpp \
+	purecontract.cpp \
+	quickenforce.cpp \
+	siteconfig.cpp \
+	suppresscontract.cpp \
+	threadcontract.cpp \
 	violationhandler.cpp
 
 HEADERS += \
-	contract_error.hpp
+	contract_error.hpp \
+	siteconfig.hpp
 
 INCLUDEPATH += \
 	../include
 
 LIBS += \
-	-lboost_unit_test_framework
+	-lboost_unit_test_framework \
+	-lrt \
+	-pthread
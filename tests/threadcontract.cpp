@@ -0,0 +1,162 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Stress tests for contracts used from many threads.  They are meant to be run
+// under ThreadSanitizer as well (-fsanitize=thread).  Boost.Test assertions
+// are not thread-safe, so the threads only count and the checks are made after
+// joining them.
+
+#include <contract/contract.hpp>
+
+#include "contract_error.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+unsigned const thread_count = 8;
+int const iterations = 20000;
+
+// Run `f(t)` on `thread_count` threads, `t` being the index of the thread.
+template <typename Func>
+void on_threads(Func f) {
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t != thread_count; ++t)
+        threads.emplace_back(f, t);
+    for (std::thread & thread: threads)
+        thread.join();
+}
+
+class ledger {
+public:
+    explicit ledger(int entries)
+        : entries_{entries}
+    {}
+
+    int entries() const {
+        CONTRACT(mfun) {
+            PRECONDITION(entries_ != 0);
+            POSTCONDITION(entries_ > 0);
+        };
+
+        return entries_;
+    }
+
+private:
+    CONTRACT(class) { INVARIANT(entries_ >= 0); };
+
+private:
+    int entries_;
+};
+
+struct handler_error {};
+
+std::atomic<int> first_handled{0};
+std::atomic<int> second_handled{0};
+
+void first_handler(contract::violation_context const &) {
+    ++first_handled;
+    throw handler_error{};
+}
+
+void second_handler(contract::violation_context const &) {
+    ++second_handled;
+    throw handler_error{};
+}
+
+void checked_transfer(int amount) {
+    CONTRACT(fun) { PRECONDITION(amount > 0); };
+}
+
+namespace observed {
+
+struct observe_policy: contract::default_policy {
+    static void handle(contract::violation_context const &) noexcept {
+        violations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static std::atomic<int> violations;
+};
+
+std::atomic<int> observe_policy::violations{0};
+
+CONTRACT_POLICY(observe_policy);
+
+void transfer(int amount) {
+    CONTRACT(fun) {
+        PRECONDITION(amount > 0);
+        POSTCONDITION_NE(amount, 13);
+    };
+}
+
+} // namespace observed
+
+} // anon namespace
+
+BOOST_AUTO_TEST_CASE(thread_shared_const_object) {
+    test::contract_handler_frame cframe;
+    ledger const shared{3};
+    std::atomic<long> total{0};
+
+    on_threads([&](unsigned) {
+        long sum = 0;
+        for (int i = 0; i != iterations; ++i)
+            sum += shared.entries();
+        total += sum;
+    });
+
+    BOOST_CHECK_EQUAL(total.load(), 3L * iterations * thread_count);
+}
+
+BOOST_AUTO_TEST_CASE(thread_set_handler_while_violating) {
+    test::contract_handler_frame cframe;
+    contract::set_handler(first_handler);
+    first_handled = second_handled = 0;
+    std::atomic<int> caught{0};
+    std::atomic<int> empty{0};
+
+    on_threads([&](unsigned t) {
+        if (t % 2 == 0) {
+            // replace the handler while the other threads call it
+            for (int i = 0; i != iterations; ++i) {
+                contract::set_handler(i % 2 ? first_handler : second_handler);
+                if (!contract::get_handler())
+                    ++empty;
+            }
+        } else {
+            for (int i = 0; i != iterations; ++i) {
+                try {
+                    checked_transfer(-1);
+                } catch (handler_error &) {
+                    ++caught;
+                }
+            }
+        }
+    });
+
+    // expect every violation to reach exactly one of the handlers
+    BOOST_CHECK_EQUAL(empty.load(), 0);
+    BOOST_CHECK_EQUAL(caught.load(), iterations * thread_count / 2);
+    BOOST_CHECK_EQUAL(first_handled.load() + second_handled.load(), caught.load());
+}
+
+BOOST_AUTO_TEST_CASE(thread_concurrent_violations) {
+    observed::observe_policy::violations = 0;
+
+    on_threads([](unsigned) {
+        for (int i = 0; i != iterations; ++i)
+            observed::transfer(i % 4 == 0 ? -1 : 13);
+    });
+
+    // a negative amount violates the precondition, 13 the postcondition
+    BOOST_CHECK_EQUAL(observed::observe_policy::violations.load(),
+                      static_cast<int>(iterations * thread_count));
+}
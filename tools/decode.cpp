@@ -0,0 +1,172 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Decoder of binary violation logs written by <contract/binary_log.hpp>.
+//
+//     contract-decode [--sites] <log>
+//
+// Prints one line per violation, with the site ids resolved to the file, line,
+// condition and message of the contract check through the site records of the
+// log.  With `--sites` only the site table is printed.
+
+#include <contract/binary_log.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct site_info {
+    contract::type contract_type;
+    std::uint32_t line;
+    std::string file;
+    std::string condition;
+    std::string message;
+};
+
+std::string operand(std::uint8_t kind, std::uint8_t size, unsigned char const * bytes) {
+    contract::captured_value const value = contract::captured_value::from_bytes(
+        static_cast<contract::captured_value::kind>(kind),
+        bytes,
+        size & ~contract::log_event::truncated_bit,
+        (size & contract::log_event::truncated_bit) != 0);
+
+    char buf[64];
+    value.format(buf, sizeof(buf));
+    return buf;
+}
+
+void print_site(std::ostream & out, std::uint64_t id, site_info const & site) {
+    out << std::hex << id << std::dec << ' '
+        << site.file << ':' << site.line << ": "
+        << contract::detail::type_name(site.contract_type) << ": "
+        << site.condition;
+    if (site.message != site.condition)
+        out << " (" << site.message << ')';
+    out << '\n';
+}
+
+int usage() {
+    std::cerr << "usage: contract-decode [--sites] <log>\n";
+    return 2;
+}
+
+} // anon namespace
+
+int main(int argc, char ** argv) {
+    bool sites_only = false;
+    char const * path = nullptr;
+
+    for (int i = 1; i != argc; ++i) {
+        if (std::strcmp(argv[i], "--sites") == 0)
+            sites_only = true;
+        else if (!path)
+            path = argv[i];
+        else
+            return usage();
+    }
+    if (!path)
+        return usage();
+
+    std::ifstream in{path, std::ios::binary};
+    std::vector<char> const log{std::istreambuf_iterator<char>(in),
+                                std::istreambuf_iterator<char>()};
+
+    contract::log_header header;
+    if (log.size() < sizeof(header)) {
+        std::cerr << path << ": not a contract violation log\n";
+        return 1;
+    }
+    std::memcpy(&header, log.data(), sizeof(header));
+    if (header.magic != contract::log_header::magic_value
+        || header.version != contract::log_header::version_value) {
+        std::cerr << path << ": not a contract violation log\n";
+        return 1;
+    }
+
+    std::size_t end = log.size();
+    if (header.tail < end)
+        end = static_cast<std::size_t>(header.tail);
+    std::size_t const slot = contract::log_header::slot_size;
+
+    // the site record of a site may follow its first events
+    std::map<std::uint64_t, site_info> sites;
+    for (std::size_t pos = slot; pos + slot <= end; pos += slot) {
+        if (log[pos] != static_cast<char>(contract::log_record_kind::site))
+            continue;
+
+        contract::log_site record;
+        std::memcpy(&record, &log[pos], sizeof(record));
+
+        std::size_t const text_end =
+            std::min(end, pos + slot * (1 + std::size_t{record.slots}));
+        char const * text = &log[pos] + offsetof(contract::log_site, text);
+        std::string fields[3];
+        for (std::string & field: fields) {
+            for (; text != &log[0] + text_end && *text; ++text)
+                field += *text;
+            if (text != &log[0] + text_end)
+                ++text;
+        }
+
+        sites[record.site] = site_info{
+            static_cast<contract::type>(record.contract_type), record.line,
+            fields[0], fields[1], fields[2]};
+        pos += slot * record.slots;
+    }
+
+    if (sites_only) {
+        for (auto const & site: sites)
+            print_site(std::cout, site.first, site.second);
+        return 0;
+    }
+
+    for (std::size_t pos = slot; pos + slot <= end; pos += slot) {
+        if (log[pos] == static_cast<char>(contract::log_record_kind::site)) {
+            contract::log_site record;
+            std::memcpy(&record, &log[pos], sizeof(record));
+            pos += slot * record.slots;
+            continue;
+        }
+        if (log[pos] != static_cast<char>(contract::log_record_kind::event))
+            continue;
+
+        contract::log_event event;
+        std::memcpy(&event, &log[pos], sizeof(event));
+
+        std::cout << event.time << ' ' << std::hex << event.thread << std::dec << ' ';
+
+        auto const site = sites.find(event.site);
+        if (site != sites.end()) {
+            std::cout << site->second.file << ':' << site->second.line << ": "
+                      << contract::detail::type_name(site->second.contract_type)
+                      << ": " << site->second.condition;
+        } else {
+            std::cout << "site " << std::hex << event.site << std::dec << ": "
+                      << contract::detail::type_name(
+                             static_cast<contract::type>(event.contract_type));
+        }
+
+        if (event.lhs_kind != 0 || event.rhs_kind != 0)
+            std::cout << " [lhs " << operand(event.lhs_kind, event.lhs_size, event.lhs)
+                      << ", rhs " << operand(event.rhs_kind, event.rhs_size, event.rhs)
+                      << ']';
+        std::cout << '\n';
+    }
+
+    if (header.dropped != 0)
+        std::cerr << path << ": " << header.dropped << " records dropped\n";
+    return 0;
+}
@@ -0,0 +1,14 @@
+TEMPLATE = app
+TARGET = contract-decode
+CONFIG += console c++11
+CONFIG -= app_bundle
+CONFIG -= qt
+
+QMAKE_CXXFLAGS += \
+	-std=c++11
+
+SOURCES += \
+	decode.cpp
+
+INCLUDEPATH += \
+	../include
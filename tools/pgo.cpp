@@ -0,0 +1,199 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Generator of contract site levels from production evaluation counts, see
+// <contract::site_config>.  The levels are chosen by how often each check ran,
+// not by what it cost: the metrics segment counts evaluations and violations
+// only.
+//
+//     contract-pgo [--sample-above <n>] [--audit-above <n>] [-o <header>] [<dump>...]
+//
+// Reads counter dumps in the format of <contract::dump_metrics> (`contract-top
+// --dump`), from the standard input if no dump is given, and adds up the
+// counters of the same site.  Writes a header to be selected with
+// `CONTRACT_SITE_CONFIG` that sets the level of every site that never failed:
+//   - sampled, if it was evaluated more than `--sample-above` times (1000000 by
+//     default), at the power-of-two rate that leaves at most that many
+//     evaluations,
+//   - audit-only, if it was evaluated more than `--audit-above` times.  The
+//     counters don't tell what a check costs, so this level is opt-in: 0 by
+//     default, which never chooses it.
+// Other sites, and any site that failed, are left at the `always` level.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct site_counters {
+    std::string type;
+    std::string location;
+    std::string condition;
+    std::uint64_t evaluations;
+    std::uint64_t violations;
+};
+
+// the highest sampling rate chosen, as in <adaptive_policy>
+std::uint64_t const max_rate = std::uint64_t{1} << 20;
+
+bool read_dump(std::istream & in, char const * name, std::map<std::uint64_t, site_counters> & sites) {
+    std::string line;
+    for (std::size_t number = 1; std::getline(in, line); ++number) {
+        if (line.empty())
+            continue;
+
+        std::istringstream fields{line};
+        std::uint64_t id = 0;
+        site_counters counters{};
+        fields >> std::hex >> id >> std::dec >> counters.type
+               >> counters.evaluations >> counters.violations >> counters.location;
+        if (!fields || id == 0) {
+            std::cerr << name << ':' << number << ": malformed line\n";
+            return false;
+        }
+        std::getline(fields >> std::ws, counters.condition);
+
+        auto const found = sites.find(id);
+        if (found == sites.end()) {
+            sites.emplace(id, counters);
+        } else {
+            found->second.evaluations += counters.evaluations;
+            found->second.violations += counters.violations;
+        }
+    }
+
+    return true;
+}
+
+// The sampling rate of a site, 1 if it is evaluated at every call.
+std::uint64_t sampling_rate(std::uint64_t evaluations, std::uint64_t sample_above) {
+    std::uint64_t rate = 1;
+    while (rate != max_rate && evaluations / rate > sample_above)
+        rate *= 2;
+    return rate;
+}
+
+int usage() {
+    std::cerr << "usage: contract-pgo [--sample-above <n>] [--audit-above <n>]"
+                 " [-o <header>] [<dump>...]\n"
+                 "the thresholds are evaluation counts; the cost of a check is not measured\n";
+    return 2;
+}
+
+} // anon namespace
+
+int main(int argc, char ** argv) {
+    std::uint64_t sample_above = 1000000;
+    std::uint64_t audit_above = 0;
+    char const * output = nullptr;
+    std::vector<char const *> dumps;
+
+    for (int i = 1; i != argc; ++i) {
+        if (std::strcmp(argv[i], "--sample-above") == 0 && i + 1 != argc)
+            sample_above = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--audit-above") == 0 && i + 1 != argc)
+            audit_above = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "-o") == 0 && i + 1 != argc)
+            output = argv[++i];
+        else if (argv[i][0] == '-' && argv[i][1] != '\0')
+            return usage();
+        else
+            dumps.push_back(argv[i]);
+    }
+    if (sample_above == 0)
+        return usage();
+
+    std::map<std::uint64_t, site_counters> sites;
+    if (dumps.empty()) {
+        if (!read_dump(std::cin, "<stdin>", sites))
+            return 1;
+    }
+    for (char const * path: dumps) {
+        std::ifstream in{path};
+        if (!in) {
+            std::cerr << path << ": can't open\n";
+            return 1;
+        }
+        if (!read_dump(in, path, sites))
+            return 1;
+    }
+
+    // in the order of the sources, so regenerated headers diff well
+    std::vector<std::pair<std::uint64_t, site_counters const *>> ordered;
+    for (auto const & site: sites)
+        ordered.emplace_back(site.first, &site.second);
+    std::sort(ordered.begin(), ordered.end(), [](
+        std::pair<std::uint64_t, site_counters const *> const & a,
+        std::pair<std::uint64_t, site_counters const *> const & b) {
+            std::string const & x = a.second->location;
+            std::string const & y = b.second->location;
+            std::size_t const xc = x.rfind(':'), yc = y.rfind(':');
+            int const files = x.compare(0, xc, y, 0, yc);
+            if (files != 0)
+                return files < 0;
+            unsigned long const xl = std::strtoul(x.c_str() + xc + 1, nullptr, 10);
+            unsigned long const yl = std::strtoul(y.c_str() + yc + 1, nullptr, 10);
+            return xl != yl ? xl < yl : a.first < b.first;
+        });
+
+    std::ofstream file;
+    if (output) {
+        file.open(output);
+        if (!file) {
+            std::cerr << output << ": can't create\n";
+            return 1;
+        }
+    }
+    std::ostream & out = output ? file : std::cout;
+
+    out << "// Contract site levels generated by contract-pgo; do not edit.\n"
+           "//\n"
+           "// Select with -DCONTRACT_SITE_CONFIG='\"<this file>\"'.  Sites that never\n"
+           "// failed are sampled by evaluation count, above " << sample_above
+        << " evaluations";
+    if (audit_above != 0)
+        out << " and audit-only\n// above " << audit_above << " evaluations";
+    out << ".\n"
+           "\n"
+           "namespace contract {\n";
+
+    std::size_t sampled = 0, audit = 0;
+    for (auto const & site: ordered) {
+        site_counters const & counters = *site.second;
+        if (counters.violations != 0 || counters.evaluations <= sample_above)
+            continue;
+
+        out << "\n// " << counters.location << ": " << counters.type << ": "
+            << counters.condition << "\n// " << counters.evaluations << " evaluations\n"
+            << "template <>\nstruct site_config<0x" << std::hex << site.first << std::dec
+            << "ull>: ";
+
+        if (audit_above != 0 && counters.evaluations > audit_above) {
+            out << "audit_site {};\n";
+            ++audit;
+        } else {
+            out << "sampled_site<" << sampling_rate(counters.evaluations, sample_above)
+                << "> {};\n";
+            ++sampled;
+        }
+    }
+
+    out << "\n} // namespace contract\n";
+
+    std::cerr << sites.size() << " sites: " << sampled << " sampled, " << audit
+              << " audit-only, " << sites.size() - sampled - audit << " always\n";
+    return out ? 0 : 1;
+}
@@ -0,0 +1,11 @@
+TEMPLATE = app
+TARGET = contract-pgo
+CONFIG += console c++11
+CONFIG -= app_bundle
+CONFIG -= qt
+
+QMAKE_CXXFLAGS += \
+	-std=c++11
+
+SOURCES += \
+	pgo.cpp
@@ -0,0 +1,199 @@
+// Copyright Alexei Zakharov, 2013.
+// Copyright niXman (i dot nixman dog gmail dot com) 2016.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Live viewer of the contract metrics of a process, see
+// <contract/metrics.hpp>.
+//
+//     contract-top [-i <ms>] [-n <rows>] [--dump] <pid | /name>
+//
+// Attaches read-only to the shared-memory metrics segment of the process and
+// shows the evaluation and violation rates of its busiest contract checks,
+// refreshed every `-i` milliseconds (1000 by default).  With `--dump` the
+// counters are printed once in the format of <contract::dump_metrics>.
+
+#include <contract/metrics.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+struct sample {
+    std::uint64_t site;
+    std::uint64_t evaluations;
+    std::uint64_t violations;
+    contract::metrics_site const * slot;
+};
+
+std::vector<sample> take_sample(char const * base) {
+    auto const * header = reinterpret_cast<contract::metrics_header const *>(base);
+    std::uint64_t used = __atomic_load_n(&header->used, __ATOMIC_RELAXED);
+    if (used > header->capacity)
+        used = header->capacity;
+
+    std::vector<sample> result;
+    for (std::uint64_t i = 0; i != used; ++i) {
+        auto const * slot = reinterpret_cast<contract::metrics_site const *>(
+            base + sizeof(contract::metrics_header) + i * header->site_size);
+        std::uint64_t const site = __atomic_load_n(&slot->site, __ATOMIC_ACQUIRE);
+        if (site != 0)
+            result.push_back(sample{
+                site,
+                __atomic_load_n(&slot->evaluations, __ATOMIC_RELAXED),
+                __atomic_load_n(&slot->violations, __ATOMIC_RELAXED),
+                slot});
+    }
+
+    return result;
+}
+
+// Counters of the previous sample by site id.  Slots claimed but not yet
+// published are left out of a sample, so samples don't line up by index.
+using counters_by_site = std::unordered_map<std::uint64_t, sample>;
+
+counters_by_site by_site(std::vector<sample> const & samples) {
+    counters_by_site result;
+    for (sample const & s: samples)
+        result.emplace(s.site, s);
+    return result;
+}
+
+// Growth of a counter since the previous sample; 0 if it went down.
+std::uint64_t growth(std::uint64_t now, std::uint64_t before) {
+    return now > before ? now - before : 0;
+}
+
+struct rate {
+    double evaluations;
+    double violations;
+    sample const * now;
+};
+
+int usage() {
+    std::cerr << "usage: contract-top [-i <ms>] [-n <rows>] [--dump] <pid | /name>\n";
+    return 2;
+}
+
+} // anon namespace
+
+int main(int argc, char ** argv) {
+    long interval = 1000;
+    std::size_t rows = 20;
+    bool dump = false;
+    std::string name;
+
+    for (int i = 1; i != argc; ++i) {
+        if (std::strcmp(argv[i], "-i") == 0 && i + 1 != argc)
+            interval = std::atol(argv[++i]);
+        else if (std::strcmp(argv[i], "-n") == 0 && i + 1 != argc)
+            rows = static_cast<std::size_t>(std::atol(argv[++i]));
+        else if (std::strcmp(argv[i], "--dump") == 0)
+            dump = true;
+        else if (name.empty())
+            name = argv[i][0] == '/' ? argv[i] : std::string("/contract-") + argv[i];
+        else
+            return usage();
+    }
+    if (name.empty() || interval <= 0)
+        return usage();
+
+    int const fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    struct ::stat st;
+    if (fd < 0 || ::fstat(fd, &st) != 0
+        || static_cast<std::size_t>(st.st_size) < sizeof(contract::metrics_header)) {
+        std::cerr << name << ": no contract metrics segment\n";
+        return 1;
+    }
+
+    void * map = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    auto const * header = static_cast<contract::metrics_header const *>(map);
+    if (map == MAP_FAILED
+        || header->magic != contract::metrics_header::magic_value
+        || header->version != contract::metrics_header::version_value
+        || static_cast<std::size_t>(st.st_size) <
+               sizeof(contract::metrics_header) + std::size_t{header->capacity} * header->site_size) {
+        std::cerr << name << ": not a contract metrics segment\n";
+        return 1;
+    }
+    char const * base = static_cast<char const *>(map);
+
+    if (dump) {
+        for (sample const & s: take_sample(base))
+            std::cout << std::hex << s.site << std::dec << ' '
+                      << contract::detail::type_name(static_cast<contract::type>(s.slot->contract_type)) << ' '
+                      << s.evaluations << ' ' << s.violations << ' '
+                      << s.slot->file << ':' << s.slot->line << ' '
+                      << s.slot->condition << '\n';
+        return 0;
+    }
+
+    counters_by_site before = by_site(take_sample(base));
+    auto then = std::chrono::steady_clock::now();
+
+    for (;;) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval));
+
+        std::vector<sample> const now = take_sample(base);
+        auto const at = std::chrono::steady_clock::now();
+        double const seconds = std::chrono::duration<double>(at - then).count();
+
+        std::vector<rate> rates;
+        for (sample const & s: now) {
+            auto const found = before.find(s.site);
+            std::uint64_t const evaluations = found != before.end() ? found->second.evaluations : 0;
+            std::uint64_t const violations = found != before.end() ? found->second.violations : 0;
+            rates.push_back(rate{growth(s.evaluations, evaluations) / seconds,
+                                 growth(s.violations, violations) / seconds,
+                                 &s});
+        }
+        std::sort(rates.begin(), rates.end(), [](rate const & a, rate const & b) {
+            return a.violations != b.violations ? a.violations > b.violations
+                                                : a.evaluations > b.evaluations;
+        });
+
+        std::cout << "\x1b[H\x1b[2J"
+                  << "contract-top  pid " << header->pid
+                  << "  sites " << now.size()
+                  << "  overflow " << __atomic_load_n(&header->overflow, __ATOMIC_RELAXED)
+                  << "\n\n"
+                  << std::setw(14) << "evals/s" << std::setw(14) << "viol/s"
+                  << std::setw(16) << "evals" << std::setw(12) << "viols"
+                  << "  type           site\n";
+
+        for (std::size_t i = 0; i != rates.size() && i != rows; ++i) {
+            sample const & s = *rates[i].now;
+            std::cout << std::fixed << std::setprecision(0)
+                      << std::setw(14) << rates[i].evaluations
+                      << std::setw(14) << rates[i].violations
+                      << std::setw(16) << s.evaluations
+                      << std::setw(12) << s.violations << "  "
+                      << std::left << std::setw(15)
+                      << contract::detail::type_name(static_cast<contract::type>(s.slot->contract_type))
+                      << std::right
+                      << s.slot->file << ':' << s.slot->line << ' ' << s.slot->condition << '\n';
+        }
+        std::cout.flush();
+
+        before = by_site(now);
+        then = at;
+    }
+}
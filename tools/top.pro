@@ -0,0 +1,17 @@
+TEMPLATE = app
+TARGET = contract-top
+CONFIG += console c++11
+CONFIG -= app_bundle
+CONFIG -= qt
+
+QMAKE_CXXFLAGS += \
+	-std=c++11
+
+SOURCES += \
+	top.cpp
+
+INCLUDEPATH += \
+	../include
+
+LIBS += \
+	-lrt